@@ -66,10 +66,18 @@ void AdsTabHelper::RunIsolatedJavaScript(
     content::RenderFrameHost* render_frame_host) {
   DCHECK(render_frame_host);
 
-  dom_distiller::RunIsolatedJavaScript(
-      render_frame_host, "new XMLSerializer().serializeToString(document)",
-      base::BindOnce(&AdsTabHelper::OnJavaScriptHtmlResult,
-                     weak_factory_.GetWeakPtr()));
+  if (!ads_service_) {
+    return;
+  }
+
+  // Serializing the document is only worth it when a conversion can match,
+  // so ask first.
+  ads_service_->ShouldLoadHtml(
+      redirect_chain_,
+      base::BindOnce(&AdsTabHelper::OnShouldLoadHtml,
+                     weak_factory_.GetWeakPtr(),
+                     render_frame_host->GetGlobalId(),
+                     redirect_chain_));
 
   dom_distiller::RunIsolatedJavaScript(
       render_frame_host, "document?.body?.innerText",
@@ -77,7 +85,44 @@ void AdsTabHelper::RunIsolatedJavaScript(
                      weak_factory_.GetWeakPtr()));
 }
 
-void AdsTabHelper::OnJavaScriptHtmlResult(base::Value value) {
+void AdsTabHelper::OnShouldLoadHtml(
+    content::GlobalRenderFrameHostId render_frame_host_id,
+    const std::vector<GURL>& redirect_chain,
+    const bool should_load) {
+  content::RenderFrameHost* render_frame_host =
+      content::RenderFrameHost::FromID(render_frame_host_id);
+  if (!ads_service_ || !render_frame_host) {
+    return;
+  }
+
+  if (should_load) {
+    dom_distiller::RunIsolatedJavaScript(
+        render_frame_host, "new XMLSerializer().serializeToString(document)",
+        base::BindOnce(&AdsTabHelper::OnJavaScriptHtmlResult,
+                       weak_factory_.GetWeakPtr(), redirect_chain));
+    return;
+  }
+
+  // The redirect chain is still needed, e.g. for ad transfers.
+  DCHECK(!redirect_chain.empty());
+  const uint32_t html_hash = base::FastHash(redirect_chain.back().spec());
+  if (html_hash != html_hash_) {
+    html_hash_ = html_hash;
+    ads_service_->OnHtmlLoaded(tab_id_, redirect_chain, "");
+  }
+
+  // The decoded response size approximates the serialized document without
+  // touching the DOM.
+  dom_distiller::RunIsolatedJavaScript(
+      render_frame_host,
+      "performance?.getEntriesByType('navigation')[0]?.decodedBodySize ?? 0",
+      base::BindOnce(&AdsTabHelper::OnJavaScriptHtmlSizeResult,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void AdsTabHelper::OnJavaScriptHtmlResult(
+    const std::vector<GURL>& redirect_chain,
+    base::Value value) {
   if (!ads_service_) {
     return;
   }
@@ -94,7 +139,18 @@ void AdsTabHelper::OnJavaScriptHtmlResult(base::Value value) {
   }
   html_hash_ = html_hash;
 
-  ads_service_->OnHtmlLoaded(tab_id_, redirect_chain_, html);
+  ads_service_->OnHtmlLoaded(tab_id_, redirect_chain, html);
+}
+
+void AdsTabHelper::OnJavaScriptHtmlSizeResult(base::Value value) {
+  if (!ads_service_) {
+    return;
+  }
+
+  const int64_t html_size =
+      value.is_int() ? value.GetInt()
+                     : static_cast<int64_t>(value.GetIfDouble().value_or(0));
+  ads_service_->OnHtmlSerializationSkipped(html_size);
 }
 
 void AdsTabHelper::OnJavaScriptTextResult(base::Value value) {
@@ -15,6 +15,7 @@
 #include "base/memory/weak_ptr.h"
 #include "build/build_config.h"
 #include "components/sessions/core/session_id.h"
+#include "content/public/browser/global_routing_id.h"
 #include "content/public/browser/media_player_id.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
@@ -59,7 +60,14 @@ class AdsTabHelper : public content::WebContentsObserver,
 
   void RunIsolatedJavaScript(content::RenderFrameHost* render_frame_host);
 
-  void OnJavaScriptHtmlResult(base::Value value);
+  void OnShouldLoadHtml(content::GlobalRenderFrameHostId render_frame_host_id,
+                        const std::vector<GURL>& redirect_chain,
+                        const bool should_load);
+
+  void OnJavaScriptHtmlResult(const std::vector<GURL>& redirect_chain,
+                              base::Value value);
+
+  void OnJavaScriptHtmlSizeResult(base::Value value);
 
   void OnJavaScriptTextResult(base::Value value);
 
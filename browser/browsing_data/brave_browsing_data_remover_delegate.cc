@@ -31,6 +31,7 @@
 #include "base/threading/thread_restrictions.h"
 #include "base/time/time.h"
 #include "brave/browser/ipfs/ipfs_service_factory.h"
+#include "brave/components/ipfs/ipfs_cid_cache.h"
 #include "brave/components/ipfs/ipfs_service.h"
 #endif
 
@@ -142,6 +143,10 @@ void BraveBrowsingDataRemoverDelegate::ClearIPFSCache() {
   if (!service)
     return;
 
+  // Responses cached by CID live in the browser profile, not the IPFS repo.
+  if (auto* cid_cache = service->GetCidCache())
+    cid_cache->Clear();
+
   base::FilePath path = service->GetIpfsExecutablePath();
   if (path.empty())
     return;
@@ -20,10 +20,13 @@
 #include "brave/components/brave_rewards/browser/test/common/rewards_browsertest_util.h"
 #include "brave/components/greaselion/browser/greaselion_download_service.h"
 #include "brave/components/greaselion/browser/greaselion_service.h"
+#include "brave/components/greaselion/browser/greaselion_service_impl.h"
 #include "chrome/browser/extensions/extension_browsertest.h"
 #include "chrome/test/base/ui_test_utils.h"
 #include "content/public/test/browser_test.h"
 #include "content/public/test/browser_test_utils.h"
+#include "extensions/browser/extension_registry.h"
+#include "extensions/browser/extension_registry_observer.h"
 #include "net/dns/mock_host_resolver.h"
 #include "ui/base/ui_base_switches.h"
 
@@ -93,6 +96,43 @@ class GreaselionServiceWaiter : public GreaselionService::Observer {
   DISALLOW_COPY_AND_ASSIGN(GreaselionServiceWaiter);
 };
 
+class ExtensionLoadCounter : public extensions::ExtensionRegistryObserver {
+ public:
+  explicit ExtensionLoadCounter(extensions::ExtensionRegistry* registry) {
+    scoped_observer_.Observe(registry);
+  }
+  ~ExtensionLoadCounter() override = default;
+
+  int loaded() const { return loaded_; }
+  int unloaded() const { return unloaded_; }
+
+  void Reset() {
+    loaded_ = 0;
+    unloaded_ = 0;
+  }
+
+ private:
+  // extensions::ExtensionRegistryObserver:
+  void OnExtensionLoaded(content::BrowserContext* browser_context,
+                         const extensions::Extension* extension) override {
+    loaded_++;
+  }
+  void OnExtensionUnloaded(
+      content::BrowserContext* browser_context,
+      const extensions::Extension* extension,
+      extensions::UnloadedExtensionReason reason) override {
+    unloaded_++;
+  }
+
+  int loaded_ = 0;
+  int unloaded_ = 0;
+  base::ScopedObservation<extensions::ExtensionRegistry,
+                          extensions::ExtensionRegistryObserver>
+      scoped_observer_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(ExtensionLoadCounter);
+};
+
 class GreaselionServiceTest : public BaseLocalDataFilesBrowserTest {
  public:
   GreaselionServiceTest(): https_server_(net::EmbeddedTestServer::TYPE_HTTPS) {
@@ -343,6 +383,57 @@ IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, ScriptInjectionWithPrecondition) {
   EXPECT_EQ(title, "Altered");
 }
 
+IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, ToggleOnlyReloadsChangedRules) {
+  ASSERT_TRUE(InstallMockExtension());
+
+  GreaselionService* greaselion_service =
+      GreaselionServiceFactory::GetForBrowserContext(profile());
+  ASSERT_TRUE(greaselion_service);
+  auto* greaselion_service_impl =
+      static_cast<greaselion::GreaselionServiceImpl*>(greaselion_service);
+  const size_t installed =
+      greaselion_service->GetExtensionIdsForTesting().size();
+  const int written =
+      greaselion_service_impl->converted_extensions_written_for_testing();
+  ExtensionLoadCounter counter(extensions::ExtensionRegistry::Get(profile()));
+
+  // Enabling auto-contribute only adds the one rule that depends on it.
+  greaselion_service->SetFeatureEnabled(greaselion::AUTO_CONTRIBUTION, true);
+  GreaselionServiceWaiter(greaselion_service).Wait();
+  EXPECT_EQ(counter.loaded(), 1);
+  EXPECT_EQ(counter.unloaded(), 0);
+  EXPECT_EQ(greaselion_service_impl->converted_extensions_written_for_testing(),
+            written + 1);
+  EXPECT_EQ(greaselion_service->GetExtensionIdsForTesting().size(),
+            installed + 1);
+
+  // Disabling it only unloads that rule and doesn't touch the disk.
+  counter.Reset();
+  greaselion_service->SetFeatureEnabled(greaselion::AUTO_CONTRIBUTION, false);
+  GreaselionServiceWaiter(greaselion_service).Wait();
+  EXPECT_EQ(counter.loaded(), 0);
+  EXPECT_EQ(counter.unloaded(), 1);
+  EXPECT_EQ(greaselion_service_impl->converted_extensions_written_for_testing(),
+            written + 1);
+  EXPECT_EQ(greaselion_service->GetExtensionIdsForTesting().size(), installed);
+
+  // Enabling it again reuses the extension converted the first time.
+  counter.Reset();
+  greaselion_service->SetFeatureEnabled(greaselion::AUTO_CONTRIBUTION, true);
+  GreaselionServiceWaiter(greaselion_service).Wait();
+  EXPECT_EQ(counter.loaded(), 1);
+  EXPECT_EQ(counter.unloaded(), 0);
+  EXPECT_EQ(greaselion_service_impl->converted_extensions_written_for_testing(),
+            written + 1);
+
+  // Toggling a feature no rule depends on doesn't reload anything.
+  counter.Reset();
+  greaselion_service->SetFeatureEnabled(greaselion::GITHUB_TIPS, true);
+  GreaselionServiceWaiter(greaselion_service).Wait();
+  EXPECT_EQ(counter.loaded(), 0);
+  EXPECT_EQ(counter.unloaded(), 0);
+}
+
 IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, IsGreaselionExtension) {
   ASSERT_TRUE(InstallMockExtension());
 
@@ -8,6 +8,10 @@
 #include <memory>
 #include <string>
 
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/location.h"
 #include "base/memory/singleton.h"
 #include "base/path_service.h"
 #include "brave/browser/brave_browser_process.h"
@@ -16,6 +20,8 @@
 #include "chrome/common/chrome_paths.h"
 #include "components/keyed_service/content/browser_context_dependency_manager.h"
 #include "components/keyed_service/core/keyed_service.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
 #include "extensions/browser/extension_file_task_runner.h"
 #include "extensions/browser/extension_registry.h"
 #include "extensions/browser/extension_registry_factory.h"
@@ -25,6 +31,36 @@
 
 namespace greaselion {
 
+namespace {
+
+// Converted extensions used to be installed to <user data>/Greaselion, which
+// all profiles shared. Deletes that directory the first time a service is
+// built in this session.
+void MaybeDeleteLegacyInstallDirectory(
+    const base::FilePath& install_directory,
+    scoped_refptr<base::SequencedTaskRunner> task_runner) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  static bool legacy_install_directory_deleted = false;
+  if (legacy_install_directory_deleted)
+    return;
+  legacy_install_directory_deleted = true;
+
+  base::FilePath user_data_dir;
+  if (!base::PathService::Get(chrome::DIR_USER_DATA, &user_data_dir))
+    return;
+  const base::FilePath legacy_install_directory =
+      user_data_dir.AppendASCII("Greaselion");
+  if (legacy_install_directory == install_directory)
+    return;
+
+  task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(base::IgnoreResult(&base::DeletePathRecursively),
+                     legacy_install_directory));
+}
+
+}  // namespace
+
 // static
 GreaselionServiceFactory* GreaselionServiceFactory::GetInstance() {
   return base::Singleton<GreaselionServiceFactory>::get();
@@ -54,11 +90,13 @@ KeyedService* GreaselionServiceFactory::BuildServiceInstanceFor(
   extension_system->InitForRegularProfile(true /* extensions_enabled */);
   extensions::ExtensionRegistry* extension_registry =
       extensions::ExtensionRegistry::Get(context);
-  base::FilePath install_directory;
-  base::PathService::Get(chrome::DIR_USER_DATA, &install_directory);
-  install_directory = install_directory.AppendASCII("Greaselion");
+  // Each profile cleans up the converted extensions its own rules no longer
+  // use, so the directory must not be shared with other profiles.
+  const base::FilePath install_directory =
+      context->GetPath().AppendASCII("Greaselion");
   scoped_refptr<base::SequencedTaskRunner> task_runner =
       extensions::GetExtensionFileTaskRunner();
+  MaybeDeleteLegacyInstallDirectory(install_directory, task_runner);
   greaselion::GreaselionDownloadService* download_service = nullptr;
   // Brave browser process may be null if we are being created within a unit
   // test.
@@ -12,6 +12,7 @@
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/ipfs/ipfs_blob_context_getter_factory.h"
 #include "brave/browser/profiles/profile_util.h"
+#include "brave/components/ipfs/ipfs_constants.h"
 #include "brave/components/ipfs/ipfs_service.h"
 #include "brave/components/ipfs/ipfs_utils.h"
 #include "chrome/common/channel_info.h"
@@ -87,9 +88,12 @@ KeyedService* IpfsServiceFactory::BuildServiceInstanceFor(
 #if BUILDFLAG(ENABLE_EXTENSIONS)
   RecordIPFSCompanionInstalled(extensions::ExtensionRegistry::Get(context));
 #endif
-  return new IpfsService(user_prefs::UserPrefs::Get(context),
-                         std::move(url_loader), std::move(context_getter),
-                         ipfs_updater, user_data_dir, chrome::GetChannel());
+  auto* service = new IpfsService(
+      user_prefs::UserPrefs::Get(context), std::move(url_loader),
+      std::move(context_getter), ipfs_updater, user_data_dir,
+      chrome::GetChannel());
+  service->InitCidCache(context->GetPath().AppendASCII(kIpfsCidCacheDirName));
+  return service;
 }
 
 // static
@@ -11,15 +11,46 @@
 
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_util.h"
 #include "brave/browser/ipfs/ipfs_blob_context_getter_factory.h"
+#include "brave/components/ipfs/import/ipfs_multipart_streamer.h"
 #include "content/public/test/browser_task_environment.h"
 #include "content/public/test/test_browser_context.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "mojo/public/cpp/system/data_pipe_drainer.h"
+#include "net/base/net_errors.h"
 #include "services/network/public/cpp/data_element.h"
 #include "services/network/public/cpp/resource_request.h"
 #include "storage/browser/blob/blob_data_builder.h"
 #include "storage/browser/blob/blob_data_item.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+namespace {
+
+class BodyCollector : public mojo::DataPipeDrainer::Client {
+ public:
+  BodyCollector(mojo::ScopedDataPipeConsumerHandle source,
+                base::OnceClosure done)
+      : done_(std::move(done)),
+        drainer_(
+            std::make_unique<mojo::DataPipeDrainer>(this, std::move(source))) {}
+
+  const std::string& body() const { return body_; }
+
+ private:
+  // mojo::DataPipeDrainer::Client
+  void OnDataAvailable(const void* data, size_t num_bytes) override {
+    body_.append(static_cast<const char*>(data), num_bytes);
+  }
+  void OnDataComplete() override { std::move(done_).Run(); }
+
+  std::string body_;
+  base::OnceClosure done_;
+  std::unique_ptr<mojo::DataPipeDrainer> drainer_;
+};
+
+}  // namespace
+
 namespace ipfs {
 
 class IpfsNetwrokUtilsUnitTest : public testing::Test {
@@ -126,21 +157,86 @@ TEST_F(IpfsNetwrokUtilsUnitTest, CreateRequestForTextTest) {
   run_loop.Run();
 }
 
-TEST_F(IpfsNetwrokUtilsUnitTest, CreateRequestForFolderTest) {
+TEST_F(IpfsNetwrokUtilsUnitTest, MultipartStreamerFolderTest) {
   base::ScopedTempDir dir;
   ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath folder = dir.GetPath().AppendASCII("folder");
+  ASSERT_TRUE(base::CreateDirectory(folder.AppendASCII("sub")));
   std::string content = "test\n\rmultiline\n\rcontent";
-  std::string filename = "test_name";
-  CreateCustomTestFile(dir.GetPath(), filename, content);
-  std::string mime_type = "test/type";
-  std::string mime_boundary = "mime_boundary";
+  CreateCustomTestFile(folder, "a.txt", content);
+  CreateCustomTestFile(folder.AppendASCII("sub"), "b.txt", "second");
+  // More files than a single enumeration batch.
+  for (size_t i = 0; i < IpfsMultipartStreamer::kEnumerationBatchSize; i++)
+    CreateCustomTestFile(folder, "file" + std::to_string(i), "x");
+
+  auto streamer = IpfsMultipartStreamer::ForFolder(folder);
+  std::string content_type = streamer->GetContentType();
+  size_t boundary_pos = content_type.find("boundary=");
+  ASSERT_NE(boundary_pos, std::string::npos);
+  std::string boundary = content_type.substr(boundary_pos + 9);
+
+  mojo::Remote<network::mojom::ChunkedDataPipeGetter> getter(
+      streamer->BindRemote());
+  base::RunLoop size_loop;
+  int32_t status = net::ERR_IO_PENDING;
+  uint64_t size = 0;
+  getter->GetSize(base::BindOnce(
+      [](int32_t* status, uint64_t* size, base::OnceClosure done,
+         int32_t result_status, uint64_t result_size) {
+        *status = result_status;
+        *size = result_size;
+        std::move(done).Run();
+      },
+      &status, &size, size_loop.QuitClosure()));
+
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  ASSERT_EQ(mojo::CreateDataPipe(nullptr, producer, consumer), MOJO_RESULT_OK);
+  getter->StartReading(std::move(producer));
+  base::RunLoop body_loop;
+  BodyCollector collector(std::move(consumer), body_loop.QuitClosure());
+  body_loop.Run();
+  size_loop.Run();
+
+  const std::string& body = collector.body();
+  EXPECT_EQ(status, net::OK);
+  EXPECT_EQ(size, body.size());
+  EXPECT_EQ(streamer->bytes_streamed(), static_cast<int64_t>(body.size()));
+  // folder/sub, folder/sub/b.txt, folder/a.txt and the generated files.
+  EXPECT_EQ(streamer->entries_streamed(),
+            IpfsMultipartStreamer::kEnumerationBatchSize + 3);
+  EXPECT_NE(body.find("filename=\"folder/a.txt\""), std::string::npos);
+  EXPECT_NE(body.find("filename=\"folder/sub\""), std::string::npos);
+  EXPECT_NE(body.find("filename=\"folder/sub/b.txt\""),
+            std::string::npos);
+  EXPECT_NE(body.find("\r\n\r\n" + content + "\r\n--" + boundary),
+            std::string::npos);
+  EXPECT_NE(body.find("\r\n\r\nsecond\r\n--" + boundary), std::string::npos);
+  EXPECT_TRUE(base::EndsWith(body, "\r\n--" + boundary + "--\r\n"));
+}
+
+TEST_F(IpfsNetwrokUtilsUnitTest, MultipartStreamerMissingFileTest) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  auto streamer = IpfsMultipartStreamer::ForFile(
+      dir.GetPath().AppendASCII("missing"), "text/plain", "missing");
+  mojo::Remote<network::mojom::ChunkedDataPipeGetter> getter(
+      streamer->BindRemote());
   base::RunLoop run_loop;
-  auto upload_callback =
-      base::BindOnce(&IpfsNetwrokUtilsUnitTest::ValidateRequest,
-                     base::Unretained(this), run_loop.QuitClosure());
-  CreateRequestForFolder(dir.GetPath(), blob_getter_factory(),
-                         std::move(upload_callback));
+  int32_t status = net::OK;
+  getter->GetSize(base::BindOnce(
+      [](int32_t* status, base::OnceClosure done, int32_t result_status,
+         uint64_t result_size) {
+        *status = result_status;
+        std::move(done).Run();
+      },
+      &status, run_loop.QuitClosure()));
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  ASSERT_EQ(mojo::CreateDataPipe(nullptr, producer, consumer), MOJO_RESULT_OK);
+  getter->StartReading(std::move(producer));
   run_loop.Run();
+  EXPECT_EQ(status, net::ERR_FILE_NOT_FOUND);
 }
 
 }  // namespace ipfs
@@ -4,12 +4,15 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "base/base64.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
 #include "base/run_loop.h"
 #include "base/strings/strcat.h"
 #include "base/strings/stringprintf.h"
 #include "base/test/mock_callback.h"
 #include "base/test/scoped_feature_list.h"
+#include "base/threading/thread_restrictions.h"
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/ipfs/ipfs_blob_context_getter_factory.h"
 #include "brave/browser/ipfs/ipfs_service_factory.h"
@@ -261,6 +264,21 @@ class IpfsServiceBrowserTest : public InProcessBrowserTest {
     return HandleImportRequests(expected_result, request);
   }
 
+  std::unique_ptr<net::test_server::HttpResponse> HandleCountingImportRequests(
+      const std::string& expected_response,
+      const net::test_server::HttpRequest& request) {
+    if (request.GetURL().path_piece() == kImportAddPath) {
+      imported_bytes_ = request.content.size();
+      imported_parts_ = 0;
+      for (size_t pos = request.content.find("Content-Disposition");
+           pos != std::string::npos;
+           pos = request.content.find("Content-Disposition", pos + 1)) {
+        imported_parts_++;
+      }
+    }
+    return HandleImportRequests(expected_response, request);
+  }
+
   std::unique_ptr<net::test_server::HttpResponse> HandleImportRequests(
       const std::string& expected_response,
       const net::test_server::HttpRequest& request) {
@@ -627,6 +645,11 @@ class IpfsServiceBrowserTest : public InProcessBrowserTest {
 
   FakeIpfsService* fake_ipfs_service() { return fake_service_.get(); }
 
+ protected:
+  // Written by the test server when the add request is handled.
+  size_t imported_bytes_ = 0;
+  size_t imported_parts_ = 0;
+
  private:
   std::unique_ptr<FakeIpfsService> fake_service_;
   std::unique_ptr<base::RunLoop> wait_for_request_;
@@ -1097,6 +1120,43 @@ IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportDirectoryToIpfsSuccess) {
   WaitForRequest();
 }
 
+// Streams a large folder through a fake /api/v0/add endpoint, logs the
+// throughput of the whole import.
+IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportLargeDirectory) {
+  constexpr size_t kFileCount = 2000;
+  constexpr size_t kFileSize = 16 * 1024;
+  base::ScopedTempDir dir;
+  base::FilePath folder;
+  {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    ASSERT_TRUE(dir.CreateUniqueTempDir());
+    folder = dir.GetPath().AppendASCII("large-folder");
+    ASSERT_TRUE(base::CreateDirectory(folder));
+    const std::string content(kFileSize, 'x');
+    for (size_t i = 0; i < kFileCount; i++) {
+      ASSERT_TRUE(base::WriteFile(
+          folder.AppendASCII("file" + std::to_string(i)), content));
+    }
+  }
+  std::string expected_response =
+      R"({"Name":"large-folder", "Size":"32768000", "Hash": "QmYbK4SLa"})";
+  ResetTestServer(
+      base::BindRepeating(&IpfsServiceBrowserTest::HandleCountingImportRequests,
+                          base::Unretained(this), expected_response));
+  ipfs_service()->ImportDirectoryToIpfs(
+      folder, std::string(),
+      base::BindOnce(&IpfsServiceBrowserTest::OnImportCompletedSuccess,
+                     base::Unretained(this)));
+  WaitForRequest();
+
+  // The folder itself and every file in it.
+  EXPECT_EQ(imported_parts_, kFileCount + 1);
+  EXPECT_GT(imported_bytes_, kFileCount * kFileSize);
+
+  base::ScopedAllowBlockingForTesting allow_blocking;
+  ASSERT_TRUE(dir.Delete());
+}
+
 IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportAndPinDirectorySuccess) {
   std::string expected_response =
       R"({"Name":"autoplay-whitelist-data", "Size":"567857", "Hash": "QmYbK4SLa"})";
@@ -0,0 +1,120 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/ad_block_cname_cache.h"
+
+#include <memory>
+
+#include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/time/default_tick_clock.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
+
+namespace brave {
+
+namespace {
+
+// User data key for AdBlockCnameCache.
+const void* const kAdBlockCnameCacheUserDataKey =
+    &kAdBlockCnameCacheUserDataKey;
+
+constexpr size_t kMaxCachedHosts = 256;
+
+// The resolver doesn't report record TTLs, so use the host cache's default
+// for system lookups.
+constexpr base::TimeDelta kCanonicalNameTTL = base::TimeDelta::FromMinutes(1);
+
+// These values are persisted to logs. Entries should not be renumbered and
+// numeric values should never be reused.
+enum class CacheLookup {
+  kHit = 0,
+  kJoinedPending = 1,
+  kMiss = 2,
+  kMaxValue = kMiss,
+};
+
+}  // namespace
+
+AdBlockCnameCache::AdBlockCnameCache()
+    : tick_clock_(base::DefaultTickClock::GetInstance()),
+      canonical_names_(kMaxCachedHosts) {}
+
+AdBlockCnameCache::~AdBlockCnameCache() = default;
+
+// static
+AdBlockCnameCache* AdBlockCnameCache::FromBrowserContext(
+    content::BrowserContext* browser_context) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  auto* self = static_cast<AdBlockCnameCache*>(
+      browser_context->GetUserData(kAdBlockCnameCacheUserDataKey));
+  if (!self) {
+    self = new AdBlockCnameCache();
+    browser_context->SetUserData(kAdBlockCnameCacheUserDataKey,
+                                 base::WrapUnique(self));
+  }
+  return self;
+}
+
+AdBlockCnameCache::LookupResult AdBlockCnameCache::Lookup(
+    const net::NetworkIsolationKey& network_isolation_key,
+    const std::string& host,
+    CanonicalNameCallback callback) {
+  Key key(network_isolation_key, host);
+
+  auto it = canonical_names_.Get(key);
+  if (it != canonical_names_.end()) {
+    if (it->second.expiry > tick_clock_->NowTicks()) {
+      UMA_HISTOGRAM_ENUMERATION("Brave.ShieldsCNAMEBlocking.CacheLookup",
+                                CacheLookup::kHit);
+      std::move(callback).Run(it->second.canonical_name);
+      return LookupResult::kCached;
+    }
+    canonical_names_.Erase(it);
+  }
+
+  auto& callbacks = pending_[std::move(key)];
+  callbacks.push_back(std::move(callback));
+  if (callbacks.size() > 1) {
+    UMA_HISTOGRAM_ENUMERATION("Brave.ShieldsCNAMEBlocking.CacheLookup",
+                              CacheLookup::kJoinedPending);
+    return LookupResult::kPending;
+  }
+  UMA_HISTOGRAM_ENUMERATION("Brave.ShieldsCNAMEBlocking.CacheLookup",
+                            CacheLookup::kMiss);
+  return LookupResult::kStartResolution;
+}
+
+void AdBlockCnameCache::OnResolved(
+    const net::NetworkIsolationKey& network_isolation_key,
+    const std::string& host,
+    absl::optional<std::string> canonical_name) {
+  Key key(network_isolation_key, host);
+
+  if (canonical_name.has_value()) {
+    canonical_names_.Put(key, Entry{*canonical_name, tick_clock_->NowTicks() +
+                                                          kCanonicalNameTTL});
+  }
+
+  auto it = pending_.find(key);
+  if (it == pending_.end())
+    return;
+  std::vector<CanonicalNameCallback> callbacks = std::move(it->second);
+  pending_.erase(it);
+  for (auto& callback : callbacks)
+    std::move(callback).Run(canonical_name);
+}
+
+base::WeakPtr<AdBlockCnameCache> AdBlockCnameCache::GetWeakPtr() {
+  return weak_factory_.GetWeakPtr();
+}
+
+void AdBlockCnameCache::SetTickClockForTesting(
+    const base::TickClock* tick_clock) {
+  tick_clock_ = tick_clock;
+}
+
+}  // namespace brave
@@ -0,0 +1,91 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_AD_BLOCK_CNAME_CACHE_H_
+#define BRAVE_BROWSER_NET_AD_BLOCK_CNAME_CACHE_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/memory/weak_ptr.h"
+#include "base/supports_user_data.h"
+#include "base/time/time.h"
+#include "net/base/network_isolation_key.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace base {
+class TickClock;
+}  // namespace base
+
+namespace content {
+class BrowserContext;
+}  // namespace content
+
+namespace brave {
+
+// Remembers the canonical names that CNAME uncloaking resolved for each
+// network isolation key and host, and coalesces concurrent resolutions of the
+// same host, so that a page loading many resources from one host only makes
+// one resolver round trip. There is one cache per profile.
+class AdBlockCnameCache : public base::SupportsUserData::Data {
+ public:
+  using CanonicalNameCallback =
+      base::OnceCallback<void(absl::optional<std::string>)>;
+
+  enum class LookupResult {
+    // |callback| was run with the cached canonical name.
+    kCached,
+    // |callback| will run when the resolution already in flight completes.
+    kPending,
+    // |callback| will run when the caller resolves the host and reports the
+    // result with OnResolved().
+    kStartResolution,
+  };
+
+  AdBlockCnameCache();
+  ~AdBlockCnameCache() override;
+
+  AdBlockCnameCache(const AdBlockCnameCache&) = delete;
+  AdBlockCnameCache& operator=(const AdBlockCnameCache&) = delete;
+
+  static AdBlockCnameCache* FromBrowserContext(
+      content::BrowserContext* browser_context);
+
+  LookupResult Lookup(const net::NetworkIsolationKey& network_isolation_key,
+                      const std::string& host,
+                      CanonicalNameCallback callback);
+
+  // Runs the callbacks waiting on |host|. Failed resolutions are passed on
+  // but not cached.
+  void OnResolved(const net::NetworkIsolationKey& network_isolation_key,
+                  const std::string& host,
+                  absl::optional<std::string> canonical_name);
+
+  base::WeakPtr<AdBlockCnameCache> GetWeakPtr();
+
+  void SetTickClockForTesting(const base::TickClock* tick_clock);
+
+ private:
+  using Key = std::pair<net::NetworkIsolationKey, std::string>;
+
+  struct Entry {
+    std::string canonical_name;
+    base::TimeTicks expiry;
+  };
+
+  const base::TickClock* tick_clock_;
+  base::MRUCache<Key, Entry> canonical_names_;
+  std::map<Key, std::vector<CanonicalNameCallback>> pending_;
+
+  base::WeakPtrFactory<AdBlockCnameCache> weak_factory_{this};
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_AD_BLOCK_CNAME_CACHE_H_
@@ -0,0 +1,107 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/ad_block_cname_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/simple_test_tick_clock.h"
+#include "net/base/schemeful_site.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+namespace {
+
+using LookupResult = AdBlockCnameCache::LookupResult;
+
+net::NetworkIsolationKey KeyForSite(const char* url) {
+  const net::SchemefulSite site(GURL{url});
+  return net::NetworkIsolationKey(site, site);
+}
+
+}  // namespace
+
+class AdBlockCnameCacheTest : public testing::Test {
+ protected:
+  void SetUp() override { cache_.SetTickClockForTesting(&clock_); }
+
+  AdBlockCnameCache::CanonicalNameCallback Record() {
+    return base::BindOnce(
+        [](std::vector<absl::optional<std::string>>* results,
+           absl::optional<std::string> canonical_name) {
+          results->push_back(std::move(canonical_name));
+        },
+        &results_);
+  }
+
+  base::SimpleTestTickClock clock_;
+  AdBlockCnameCache cache_;
+  std::vector<absl::optional<std::string>> results_;
+};
+
+TEST_F(AdBlockCnameCacheTest, CoalescesAndCachesResolutions) {
+  const auto key = KeyForSite("https://example.com");
+
+  EXPECT_EQ(LookupResult::kStartResolution,
+            cache_.Lookup(key, "tracker.example.com", Record()));
+  EXPECT_EQ(LookupResult::kPending,
+            cache_.Lookup(key, "tracker.example.com", Record()));
+  EXPECT_TRUE(results_.empty());
+
+  cache_.OnResolved(key, "tracker.example.com", std::string("ads.net"));
+  ASSERT_EQ(2u, results_.size());
+  EXPECT_EQ("ads.net", results_[0]);
+  EXPECT_EQ("ads.net", results_[1]);
+
+  EXPECT_EQ(LookupResult::kCached,
+            cache_.Lookup(key, "tracker.example.com", Record()));
+  ASSERT_EQ(3u, results_.size());
+  EXPECT_EQ("ads.net", results_[2]);
+}
+
+TEST_F(AdBlockCnameCacheTest, EntriesExpire) {
+  const auto key = KeyForSite("https://example.com");
+
+  cache_.Lookup(key, "tracker.example.com", Record());
+  cache_.OnResolved(key, "tracker.example.com", std::string("ads.net"));
+  clock_.Advance(base::TimeDelta::FromSeconds(30));
+  EXPECT_EQ(LookupResult::kCached,
+            cache_.Lookup(key, "tracker.example.com", Record()));
+
+  clock_.Advance(base::TimeDelta::FromMinutes(1));
+  EXPECT_EQ(LookupResult::kStartResolution,
+            cache_.Lookup(key, "tracker.example.com", Record()));
+}
+
+TEST_F(AdBlockCnameCacheTest, FailuresAreNotCached) {
+  const auto key = KeyForSite("https://example.com");
+
+  cache_.Lookup(key, "tracker.example.com", Record());
+  cache_.OnResolved(key, "tracker.example.com", absl::nullopt);
+  ASSERT_EQ(1u, results_.size());
+  EXPECT_FALSE(results_[0].has_value());
+
+  EXPECT_EQ(LookupResult::kStartResolution,
+            cache_.Lookup(key, "tracker.example.com", Record()));
+}
+
+TEST_F(AdBlockCnameCacheTest, PartitionedByNetworkIsolationKey) {
+  const auto key = KeyForSite("https://example.com");
+  const auto other_key = KeyForSite("https://other.com");
+
+  cache_.Lookup(key, "tracker.example.com", Record());
+  cache_.OnResolved(key, "tracker.example.com", std::string("ads.net"));
+
+  EXPECT_EQ(LookupResult::kStartResolution,
+            cache_.Lookup(other_key, "tracker.example.com", Record()));
+  EXPECT_EQ(LookupResult::kStartResolution,
+            cache_.Lookup(key, "other.example.com", Record()));
+}
+
+}  // namespace brave
@@ -15,6 +15,7 @@
 #include "base/strings/string_util.h"
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
+#include "brave/browser/net/ad_block_cname_cache.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
 #include "brave/common/url_constants.h"
@@ -66,6 +67,7 @@ void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
                     const ResponseCallback& next_callback,
                     std::shared_ptr<BraveRequestInfo> ctx,
                     EngineFlags previous_result,
+                    base::TimeTicks lookup_start,
                     absl::optional<std::string> cname);
 
 class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
@@ -76,13 +78,10 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
 
  public:
   AdblockCnameResolveHostClient(
-      const ResponseCallback& next_callback,
-      scoped_refptr<base::SequencedTaskRunner> task_runner,
       std::shared_ptr<BraveRequestInfo> ctx,
-      EngineFlags previous_result) {
+      base::OnceCallback<void(absl::optional<std::string>)> cb)
+      : cb_(std::move(cb)) {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-    cb_ = base::BindOnce(&UseCnameResult, task_runner, std::move(next_callback),
-                         ctx, previous_result);
 
     const auto network_isolation_key = ctx->network_isolation_key;
 
@@ -199,6 +198,30 @@ EngineFlags ShouldBlockRequestOnTaskRunner(
   return previous_result;
 }
 
+// Requests to the same host share one resolution, and its result is cached for
+// later requests made under the same network isolation key.
+void ResolveCanonicalName(scoped_refptr<base::SequencedTaskRunner> task_runner,
+                          const ResponseCallback& next_callback,
+                          std::shared_ptr<BraveRequestInfo> ctx,
+                          EngineFlags previous_result) {
+  DCHECK(ctx->browser_context);
+  const std::string host = ctx->request_url.host();
+  AdBlockCnameCache* cache =
+      AdBlockCnameCache::FromBrowserContext(ctx->browser_context);
+  if (cache->Lookup(ctx->network_isolation_key, host,
+                    base::BindOnce(&UseCnameResult, task_runner, next_callback,
+                                   ctx, previous_result,
+                                   base::TimeTicks::Now())) !=
+      AdBlockCnameCache::LookupResult::kStartResolution) {
+    return;
+  }
+
+  // This will be deleted by `AdblockCnameResolveHostClient::OnComplete`.
+  new AdblockCnameResolveHostClient(
+      ctx, base::BindOnce(&AdBlockCnameCache::OnResolved, cache->GetWeakPtr(),
+                          ctx->network_isolation_key, host));
+}
+
 void OnShouldBlockRequestResult(
     bool then_check_uncloaked,
     scoped_refptr<base::SequencedTaskRunner> task_runner,
@@ -210,9 +233,7 @@ void OnShouldBlockRequestResult(
     brave_shields::BraveShieldsWebContentsObserver::DispatchBlockedEvent(
         ctx->request_url, ctx->frame_tree_node_id, brave_shields::kAds);
   } else if (then_check_uncloaked) {
-    // This will be deleted by `AdblockCnameResolveHostClient::OnComplete`.
-    new AdblockCnameResolveHostClient(std::move(next_callback), task_runner,
-                                      ctx, result);
+    ResolveCanonicalName(task_runner, next_callback, ctx, result);
     return;
   }
   next_callback.Run();
@@ -222,8 +243,11 @@ void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
                     const ResponseCallback& next_callback,
                     std::shared_ptr<BraveRequestInfo> ctx,
                     EngineFlags previous_result,
+                    base::TimeTicks lookup_start,
                     absl::optional<std::string> cname) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  UMA_HISTOGRAM_TIMES("Brave.ShieldsCNAMEBlocking.AddedLatency",
+                      base::TimeTicks::Now() - lookup_start);
 
   if (cname.has_value() && ctx->request_url.host() != *cname &&
       !cname->empty()) {
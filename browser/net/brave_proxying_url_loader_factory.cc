@@ -15,6 +15,7 @@
 #include "brave/browser/net/brave_request_handler.h"
 #include "brave/components/brave_shields/browser/adblock_stub_response.h"
 #include "brave/components/brave_shields/common/features.h"
+#include "brave/components/ipfs/buildflags/buildflags.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
@@ -24,6 +25,8 @@
 #include "mojo/public/cpp/system/string_data_source.h"
 #include "net/base/completion_repeating_callback.h"
 #include "net/cookies/site_for_cookies.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
 #include "net/http/http_util.h"
 #include "net/url_request/redirect_info.h"
 #include "net/url_request/redirect_util.h"
@@ -33,6 +36,13 @@
 #include "services/network/public/mojom/early_hints.mojom.h"
 #include "url/origin.h"
 
+#if BUILDFLAG(ENABLE_IPFS)
+#include "brave/browser/ipfs/ipfs_service_factory.h"
+#include "brave/components/ipfs/ipfs_cid_cache.h"
+#include "brave/components/ipfs/ipfs_cid_cache_body_tee.h"
+#include "brave/components/ipfs/ipfs_service.h"
+#endif
+
 namespace {
 
 // Helper struct for crafting responses.
@@ -80,6 +90,13 @@ net::RedirectInfo CreateRedirectInfo(
       false /* is_signed_exchange_fallback_redirect */);
 }
 
+#if BUILDFLAG(ENABLE_IPFS)
+ipfs::IpfsCidCache* GetIpfsCidCache(content::BrowserContext* browser_context) {
+  auto* service = ipfs::IpfsServiceFactory::GetForContext(browser_context);
+  return service ? service->GetCidCache() : nullptr;
+}
+#endif
+
 }  // namespace
 
 BraveProxyingURLLoaderFactory::InProgressRequest::FollowRedirectParams::
@@ -120,6 +137,10 @@ BraveProxyingURLLoaderFactory::InProgressRequest::InProgressRequest(
 }
 
 BraveProxyingURLLoaderFactory::InProgressRequest::~InProgressRequest() {
+#if BUILDFLAG(ENABLE_IPFS)
+  if (ipfs_cache_tee_)
+    ipfs_cache_tee_->OnLoadComplete(false);
+#endif
   if (ctx_) {
     factory_->request_handler_->OnURLRequestDestroyed(ctx_);
   }
@@ -261,6 +282,20 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::OnTransferSizeUpdated(
 
 void BraveProxyingURLLoaderFactory::InProgressRequest::
     OnStartLoadingResponseBody(mojo::ScopedDataPipeConsumerHandle body) {
+#if BUILDFLAG(ENABLE_IPFS)
+  auto* cid_cache =
+      ipfs_cache_fill_ ? GetIpfsCidCache(browser_context_) : nullptr;
+  ipfs_cache_fill_ = false;
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  if (cid_cache &&
+      CreateDataPipe(nullptr, producer, consumer) == MOJO_RESULT_OK) {
+    ipfs_cache_tee_ = ipfs::IpfsCidCacheBodyTee::Start(
+        std::move(body), std::move(producer), cid_cache->AsWeakPtr(),
+        ipfs_cache_key_, ipfs_cache_raw_headers_);
+    body = std::move(consumer);
+  }
+#endif
   target_client_->OnStartLoadingResponseBody(std::move(body));
 }
 
@@ -268,6 +303,12 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::OnComplete(
     const network::URLLoaderCompletionStatus& status) {
   UMA_HISTOGRAM_TIMES("Brave.ProxyingURLLoader.TotalRequestTime",
                       base::TimeTicks::Now() - start_time_);
+#if BUILDFLAG(ENABLE_IPFS)
+  if (ipfs_cache_tee_) {
+    ipfs_cache_tee_->OnLoadComplete(status.error_code == net::OK);
+    ipfs_cache_tee_ = nullptr;
+  }
+#endif
   if (status.error_code != net::OK) {
     OnRequestError(status);
     return;
@@ -361,36 +402,17 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
     std::string response_data;
     brave_shields::MakeStubResponse(ctx_->mock_data_url, request_, &response,
                                     &response_data);
-
-    target_client_->OnReceiveResponse(std::move(response));
-
-    // Create a data pipe for transmitting the response.
-    mojo::ScopedDataPipeProducerHandle producer;
-    mojo::ScopedDataPipeConsumerHandle consumer;
-    if (CreateDataPipe(nullptr, producer, consumer) != MOJO_RESULT_OK) {
-      OnRequestError(
-          network::URLLoaderCompletionStatus(net::ERR_INSUFFICIENT_RESOURCES));
-      return;
-    }
-
-    // Craft the response.
-    target_client_->OnStartLoadingResponseBody(std::move(consumer));
-
-    auto write_data = std::make_unique<WriteData>();
-    write_data->client = weak_factory_.GetWeakPtr();
-    write_data->data = response_data;
-    write_data->producer =
-        std::make_unique<mojo::DataPipeProducer>(std::move(producer));
-
-    base::StringPiece string_piece(write_data->data);
-    write_data->producer->Write(
-        std::make_unique<mojo::StringDataSource>(
-            string_piece, mojo::StringDataSource::AsyncWritingMode::
-                              STRING_STAYS_VALID_UNTIL_COMPLETION),
-        base::BindOnce(OnWrite, std::move(write_data)));
+    RespondWithData(std::move(response), response_data);
     return;
   }
 
+  ipfs_cache_key_ = ctx_->ipfs_cache_key;
+  // Partial responses are neither served from nor stored in the cache.
+  if (request_.headers.HasHeader(net::HttpRequestHeaders::kRange))
+    ipfs_cache_key_.clear();
+  ipfs_cache_checked_ = false;
+  ipfs_cache_fill_ = false;
+
   if (request_.url.SchemeIsHTTPOrHTTPS()) {
     auto continuation = base::BindRepeating(
         &InProgressRequest::ContinueToSendHeaders, weak_factory_.GetWeakPtr());
@@ -434,6 +456,20 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::ContinueToStartRequest(
   if (proxied_client_receiver_.is_bound())
     proxied_client_receiver_.Resume();
 
+#if BUILDFLAG(ENABLE_IPFS)
+  if (!target_loader_.is_bound() && !ipfs_cache_key_.empty() &&
+      !ipfs_cache_checked_) {
+    if (auto* cid_cache = GetIpfsCidCache(browser_context_)) {
+      ipfs_cache_checked_ = true;
+      cid_cache->Lookup(
+          ipfs_cache_key_,
+          base::BindOnce(&InProgressRequest::OnIpfsCidCacheLookup,
+                         weak_factory_.GetWeakPtr()));
+      return;
+    }
+  }
+#endif
+
   if (!target_loader_.is_bound() && factory_->target_factory_.is_bound()) {
     // Nothing has cancelled us up to this point, so it's now OK to
     // initiate the real network request.
@@ -496,6 +532,21 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
     return;
   }
 
+  if (ipfs_cache_fill_) {
+    // Only complete responses are worth keeping. The headers are stored as
+    // the server sent them, before any OnHeadersReceived changes, and
+    // without cookies.
+    ipfs_cache_fill_ =
+        current_response_->headers &&
+        current_response_->headers->response_code() == net::HTTP_OK;
+    if (ipfs_cache_fill_) {
+      auto headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+          current_response_->headers->raw_headers());
+      headers->RemoveHeader("set-cookie");
+      ipfs_cache_raw_headers_ = headers->raw_headers();
+    }
+  }
+
   if (override_headers_) {
     current_response_->headers = override_headers_;
     // Since we overrode headers we should reparse them:
@@ -531,6 +582,12 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
     return;
   }
 
+  if (ipfs_cache_hit_) {
+    ipfs_cache_hit_ = false;
+    RespondWithData(std::move(current_response_), ipfs_cache_hit_body_);
+    return;
+  }
+
   proxied_client_receiver_.Resume();
   target_client_->OnReceiveResponse(std::move(current_response_));
 }
@@ -546,6 +603,11 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::ContinueToBeforeRedirect(
   if (proxied_client_receiver_.is_bound())
     proxied_client_receiver_.Resume();
 
+  // The cache key belongs to the URL we are redirected away from.
+  ipfs_cache_fill_ = false;
+  ipfs_cache_hit_ = false;
+  ipfs_cache_hit_body_.clear();
+
   if (ctx_->internal_redirect) {
     ctx_->redirect_source = GURL();
   } else {
@@ -598,7 +660,8 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
       // continue or cancel the request.
       //
       // We pause the binding here to prevent further client message processing.
-      proxied_client_receiver_.Pause();
+      if (proxied_client_receiver_.is_bound())
+        proxied_client_receiver_.Pause();
       return;
     }
 
@@ -608,6 +671,65 @@ void BraveProxyingURLLoaderFactory::InProgressRequest::
   std::move(split_once_callback.second).Run(net::OK);
 }
 
+void BraveProxyingURLLoaderFactory::InProgressRequest::RespondWithData(
+    network::mojom::URLResponseHeadPtr head,
+    const std::string& data) {
+  target_client_->OnReceiveResponse(std::move(head));
+
+  // Create a data pipe for transmitting the response.
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  if (CreateDataPipe(nullptr, producer, consumer) != MOJO_RESULT_OK) {
+    OnRequestError(
+        network::URLLoaderCompletionStatus(net::ERR_INSUFFICIENT_RESOURCES));
+    return;
+  }
+
+  // Craft the response.
+  target_client_->OnStartLoadingResponseBody(std::move(consumer));
+
+  auto write_data = std::make_unique<WriteData>();
+  write_data->client = weak_factory_.GetWeakPtr();
+  write_data->data = data;
+  write_data->producer =
+      std::make_unique<mojo::DataPipeProducer>(std::move(producer));
+
+  base::StringPiece string_piece(write_data->data);
+  write_data->producer->Write(
+      std::make_unique<mojo::StringDataSource>(
+          string_piece, mojo::StringDataSource::AsyncWritingMode::
+                            STRING_STAYS_VALID_UNTIL_COMPLETION),
+      base::BindOnce(OnWrite, std::move(write_data)));
+}
+
+void BraveProxyingURLLoaderFactory::InProgressRequest::OnIpfsCidCacheLookup(
+    bool found,
+    const std::string& raw_headers,
+    const std::string& body) {
+  if (!found) {
+    ipfs_cache_fill_ = true;
+    ContinueToStartRequest(net::OK);
+    return;
+  }
+
+  // Replay the stored response through the same header handling a network
+  // response gets.
+  current_response_ = network::mojom::URLResponseHead::New();
+  current_response_->headers =
+      base::MakeRefCounted<net::HttpResponseHeaders>(raw_headers);
+  current_response_->headers->GetMimeTypeAndCharset(
+      &current_response_->mime_type, &current_response_->charset);
+  current_response_->content_length = body.size();
+  current_response_->request_time = current_response_->response_time =
+      base::Time::Now();
+  ipfs_cache_hit_ = true;
+  ipfs_cache_hit_body_ = body;
+  ctx_->internal_redirect = false;
+  HandleResponseOrRedirectHeaders(
+      base::BindRepeating(&InProgressRequest::ContinueToResponseStarted,
+                          weak_factory_.GetWeakPtr()));
+}
+
 void BraveProxyingURLLoaderFactory::InProgressRequest::OnRequestError(
     const network::URLLoaderCompletionStatus& status) {
   if (!request_completed_) {
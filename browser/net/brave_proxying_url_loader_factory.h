@@ -41,6 +41,10 @@ class BrowserContext;
 class RenderFrameHost;
 }  // namespace content
 
+namespace ipfs {
+class IpfsCidCacheBodyTee;
+}  // namespace ipfs
+
 // Cargoculted from WebRequestProxyingURLLoaderFactory and
 // signin::ProxyingURLLoaderFactory
 class BraveProxyingURLLoaderFactory
@@ -111,6 +115,12 @@ class BraveProxyingURLLoaderFactory
         net::CompletionOnceCallback continuation);
     void OnRequestError(const network::URLLoaderCompletionStatus& status);
     void HandleBeforeRequestRedirect();
+    // Answers the request with |head| and |data| instead of starting a load.
+    void RespondWithData(network::mojom::URLResponseHeadPtr head,
+                         const std::string& data);
+    void OnIpfsCidCacheLookup(bool found,
+                              const std::string& raw_headers,
+                              const std::string& body);
 
     base::TimeTicks start_time_;
 
@@ -167,6 +177,18 @@ class BraveProxyingURLLoaderFactory
     };
     std::unique_ptr<FollowRedirectParams> pending_follow_redirect_params_;
 
+    // IPFS CID cache state, see |brave::BraveRequestInfo::ipfs_cache_key|.
+    std::string ipfs_cache_key_;
+    bool ipfs_cache_checked_ = false;
+    // Whether the response should be copied into the cache.
+    bool ipfs_cache_fill_ = false;
+    std::string ipfs_cache_raw_headers_;
+    // Body of a cache hit, sent once the headers went through
+    // OnHeadersReceived like a network response would.
+    bool ipfs_cache_hit_ = false;
+    std::string ipfs_cache_hit_body_;
+    base::WeakPtr<ipfs::IpfsCidCacheBodyTee> ipfs_cache_tee_;
+
     base::WeakPtrFactory<InProgressRequest> weak_factory_;
 
     DISALLOW_COPY_AND_ASSIGN(InProgressRequest);
@@ -10,6 +10,7 @@
 
 #include "base/containers/contains.h"
 #include "base/feature_list.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/task/post_task.h"
 #include "brave/browser/net/brave_ad_block_csp_network_delegate_helper.h"
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
@@ -155,9 +156,7 @@ int BraveRequestHandler::OnBeforeURLRequest(
   }
   ctx->new_url = new_url;
   ctx->event_type = brave::kOnBeforeRequest;
-  callbacks_[ctx->request_identifier] = std::move(callback);
-  RunNextCallback(ctx);
-  return net::ERR_IO_PENDING;
+  return StartCallbacks(ctx, std::move(callback));
 }
 
 int BraveRequestHandler::OnBeforeStartTransaction(
@@ -169,9 +168,7 @@ int BraveRequestHandler::OnBeforeStartTransaction(
   }
   ctx->event_type = brave::kOnBeforeStartTransaction;
   ctx->headers = headers;
-  callbacks_[ctx->request_identifier] = std::move(callback);
-  RunNextCallback(ctx);
-  return net::ERR_IO_PENDING;
+  return StartCallbacks(ctx, std::move(callback));
 }
 
 int BraveRequestHandler::OnHeadersReceived(
@@ -192,14 +189,12 @@ int BraveRequestHandler::OnHeadersReceived(
     return net::OK;
   }
 
-  callbacks_[ctx->request_identifier] = std::move(callback);
   ctx->event_type = brave::kOnHeadersReceived;
   ctx->original_response_headers = original_response_headers;
   ctx->override_response_headers = override_response_headers;
   ctx->allowed_unsafe_redirect_url = allowed_unsafe_redirect_url;
 
-  RunNextCallback(ctx);
-  return net::ERR_IO_PENDING;
+  return StartCallbacks(ctx, std::move(callback));
 }
 
 void BraveRequestHandler::OnURLRequestDestroyed(
@@ -220,16 +215,86 @@ void BraveRequestHandler::RunCallbackForRequestIdentifier(
                  base::BindOnce(std::move(it->second), rv));
 }
 
-// TODO(iefremov): Merge all callback containers into one and run only one loop
-// instead of many (issues/5574).
+void BraveRequestHandler::SetOnBeforeURLRequestCallbacksForTesting(
+    std::vector<brave::OnBeforeURLRequestCallback> callbacks) {
+  before_url_request_callbacks_ = std::move(callbacks);
+}
+
+int BraveRequestHandler::StartCallbacks(
+    std::shared_ptr<brave::BraveRequestInfo> ctx,
+    net::CompletionOnceCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  ctx->interception_start_time = base::TimeTicks::Now();
+  ctx->interception_ui_tasks = 0;
+  callbacks_[ctx->request_identifier] = std::move(callback);
+
+  ctx->in_synchronous_dispatch = true;
+  int rv = RunCallbacks(ctx);
+  ctx->in_synchronous_dispatch = false;
+
+  if (rv == net::ERR_IO_PENDING)
+    return rv;
+
+  // When no helper had to go asynchronous the result is returned directly,
+  // which the loader handles without another trip through the UI thread.
+  if (rv == net::OK || rv == net::ERR_BLOCKED_BY_CLIENT) {
+    callbacks_.erase(ctx->request_identifier);
+    RecordInterceptionMetrics(ctx);
+    return rv;
+  }
+
+  ctx->interception_ui_tasks++;
+  RecordInterceptionMetrics(ctx);
+  RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
+  return net::ERR_IO_PENDING;
+}
+
 void BraveRequestHandler::RunNextCallback(
     std::shared_ptr<brave::BraveRequestInfo> ctx) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
-  if (!base::Contains(callbacks_, ctx->request_identifier)) {
+  if (!IsRequestIdentifierValid(ctx->request_identifier))
+    return;
+
+  ctx->interception_ui_tasks++;
+  const int rv = RunCallbacks(ctx);
+  if (rv == net::ERR_IO_PENDING)
+    return;
+
+  // A helper that resumed us before returning from its own call is still
+  // nested inside StartCallbacks(), so the loader must hear back later.
+  if (ctx->in_synchronous_dispatch) {
+    ctx->interception_ui_tasks++;
+    RecordInterceptionMetrics(ctx);
+    RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
     return;
   }
 
+  // Otherwise this already runs in a task of its own and the loader can be
+  // resumed right away. The entry is dropped first as the loader may start
+  // the next stage for this request synchronously.
+  auto it = callbacks_.find(ctx->request_identifier);
+  net::CompletionOnceCallback callback = std::move(it->second);
+  callbacks_.erase(it);
+  RecordInterceptionMetrics(ctx);
+  std::move(callback).Run(rv);
+}
+
+void BraveRequestHandler::RecordInterceptionMetrics(
+    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  UMA_HISTOGRAM_TIMES("Brave.RequestHandler.InterceptionTime",
+                      base::TimeTicks::Now() - ctx->interception_start_time);
+  UMA_HISTOGRAM_EXACT_LINEAR("Brave.RequestHandler.UIThreadTasks",
+                             ctx->interception_ui_tasks, 10);
+}
+
+// TODO(iefremov): Merge all callback containers into one and run only one loop
+// instead of many (issues/5574).
+int BraveRequestHandler::RunCallbacks(
+    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
   // Continue processing callbacks until we hit one that returns PENDING
   int rv = net::OK;
 
@@ -243,7 +308,7 @@ void BraveRequestHandler::RunNextCallback(
                               weak_factory_.GetWeakPtr(), ctx);
       rv = callback.Run(next_callback, ctx);
       if (rv == net::ERR_IO_PENDING) {
-        return;
+        return rv;
       }
       if (rv != net::OK) {
         break;
@@ -259,7 +324,7 @@ void BraveRequestHandler::RunNextCallback(
                               weak_factory_.GetWeakPtr(), ctx);
       rv = callback.Run(ctx->headers, next_callback, ctx);
       if (rv == net::ERR_IO_PENDING) {
-        return;
+        return rv;
       }
       if (rv != net::OK) {
         break;
@@ -276,7 +341,7 @@ void BraveRequestHandler::RunNextCallback(
                         ctx->override_response_headers,
                         ctx->allowed_unsafe_redirect_url, next_callback, ctx);
       if (rv == net::ERR_IO_PENDING) {
-        return;
+        return rv;
       }
       if (rv != net::OK) {
         break;
@@ -284,10 +349,8 @@ void BraveRequestHandler::RunNextCallback(
     }
   }
 
-  if (rv != net::OK) {
-    RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
-    return;
-  }
+  if (rv != net::OK)
+    return rv;
 
   if (ctx->event_type == brave::kOnBeforeRequest) {
     if (!ctx->new_url_spec.empty() &&
@@ -297,12 +360,9 @@ void BraveRequestHandler::RunNextCallback(
     }
     if (ctx->blocked_by == brave::kAdBlocked ||
         ctx->blocked_by == brave::kOtherBlocked) {
-      if (!ctx->ShouldMockRequest()) {
-        RunCallbackForRequestIdentifier(ctx->request_identifier,
-                                        net::ERR_BLOCKED_BY_CLIENT);
-        return;
-      }
+      if (!ctx->ShouldMockRequest())
+        return net::ERR_BLOCKED_BY_CLIENT;
     }
   }
-  RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
+  return net::OK;
 }
@@ -43,9 +43,20 @@ class BraveRequestHandler {
   void OnURLRequestDestroyed(std::shared_ptr<brave::BraveRequestInfo> ctx);
   void RunCallbackForRequestIdentifier(uint64_t request_identifier, int rv);
 
+  void SetOnBeforeURLRequestCallbacksForTesting(
+      std::vector<brave::OnBeforeURLRequestCallback> callbacks);
+
  private:
   void SetupCallbacks();
+  // Runs the helpers for the current event of |ctx| and returns
+  // net::ERR_IO_PENDING if the result will be reported to |callback| later.
+  int StartCallbacks(std::shared_ptr<brave::BraveRequestInfo> ctx,
+                     net::CompletionOnceCallback callback);
+  // Continues the helpers after one of them finished its asynchronous work.
   void RunNextCallback(std::shared_ptr<brave::BraveRequestInfo> ctx);
+  int RunCallbacks(std::shared_ptr<brave::BraveRequestInfo> ctx);
+  void RecordInterceptionMetrics(
+      std::shared_ptr<brave::BraveRequestInfo> ctx);
 
   std::vector<brave::OnBeforeURLRequestCallback> before_url_request_callbacks_;
   std::vector<brave::OnBeforeStartTransactionCallback>
@@ -0,0 +1,213 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_request_handler.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "brave/browser/net/url_context.h"
+#include "content/public/test/browser_task_environment.h"
+#include "net/base/net_errors.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+constexpr char kUIThreadTasksHistogram[] = "Brave.RequestHandler.UIThreadTasks";
+constexpr uint64_t kRequestIdentifier = 1;
+
+int CountingHelper(int* calls,
+                   const brave::ResponseCallback& next_callback,
+                   std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  (*calls)++;
+  return net::OK;
+}
+
+int BlockingHelper(const brave::ResponseCallback& next_callback,
+                   std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  ctx->blocked_by = brave::kAdBlocked;
+  return net::OK;
+}
+
+int RedirectingHelper(const brave::ResponseCallback& next_callback,
+                      std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  ctx->new_url_spec = "https://example.com/";
+  return net::OK;
+}
+
+// Keeps |next_callback| to resume the chain later, like a helper that posts
+// its work to another sequence.
+int PendingHelper(brave::ResponseCallback* resume,
+                  const brave::ResponseCallback& next_callback,
+                  std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  *resume = next_callback;
+  return net::ERR_IO_PENDING;
+}
+
+// Resumes the chain before returning from its own call.
+int ReentrantHelper(const brave::ResponseCallback& next_callback,
+                    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  next_callback.Run();
+  return net::ERR_IO_PENDING;
+}
+
+}  // namespace
+
+class BraveRequestHandlerTest : public testing::Test {
+ public:
+  BraveRequestHandlerTest() = default;
+  ~BraveRequestHandlerTest() override = default;
+
+  void SetUp() override {
+    handler_ = std::make_unique<BraveRequestHandler>();
+    ctx_ = std::make_shared<brave::BraveRequestInfo>(
+        GURL("https://brave.com/"));
+    ctx_->request_identifier = kRequestIdentifier;
+  }
+
+  int OnBeforeURLRequest(
+      std::vector<brave::OnBeforeURLRequestCallback> callbacks) {
+    handler_->SetOnBeforeURLRequestCallbacksForTesting(std::move(callbacks));
+    return handler_->OnBeforeURLRequest(
+        ctx_,
+        base::BindOnce(
+            [](std::vector<int>* results, int rv) { results->push_back(rv); },
+            &results_),
+        &new_url_);
+  }
+
+  BraveRequestHandler* handler() { return handler_.get(); }
+  const std::vector<int>& results() const { return results_; }
+  const GURL& new_url() const { return new_url_; }
+
+ private:
+  content::BrowserTaskEnvironment task_environment_;
+  std::unique_ptr<BraveRequestHandler> handler_;
+  std::shared_ptr<brave::BraveRequestInfo> ctx_;
+  std::vector<int> results_;
+  GURL new_url_;
+};
+
+TEST_F(BraveRequestHandlerTest, SynchronousHelpersReturnResultDirectly) {
+  base::HistogramTester histogram_tester;
+  int calls = 0;
+
+  EXPECT_EQ(OnBeforeURLRequest(
+                {base::BindRepeating(&CountingHelper, &calls),
+                 base::BindRepeating(&RedirectingHelper),
+                 base::BindRepeating(&CountingHelper, &calls)}),
+            net::OK);
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(new_url(), GURL("https://example.com/"));
+  EXPECT_FALSE(handler()->IsRequestIdentifierValid(kRequestIdentifier));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(results().empty());
+  histogram_tester.ExpectUniqueSample(kUIThreadTasksHistogram, 0, 1);
+}
+
+TEST_F(BraveRequestHandlerTest, SynchronousBlockIsReturnedDirectly) {
+  int calls = 0;
+
+  EXPECT_EQ(OnBeforeURLRequest({base::BindRepeating(&BlockingHelper),
+                                base::BindRepeating(&CountingHelper, &calls)}),
+            net::ERR_BLOCKED_BY_CLIENT);
+  EXPECT_EQ(calls, 1);
+  EXPECT_FALSE(handler()->IsRequestIdentifierValid(kRequestIdentifier));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(results().empty());
+}
+
+TEST_F(BraveRequestHandlerTest, ReentrantResumeCompletesInPostedTask) {
+  base::HistogramTester histogram_tester;
+  int calls = 0;
+
+  EXPECT_EQ(OnBeforeURLRequest({base::BindRepeating(&ReentrantHelper),
+                                base::BindRepeating(&CountingHelper, &calls)}),
+            net::ERR_IO_PENDING);
+  // The rest of the chain ran inside the helper's call, but the loader is
+  // still waiting for OnBeforeURLRequest() to return.
+  EXPECT_EQ(calls, 1);
+  EXPECT_TRUE(results().empty());
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(results(), std::vector<int>({net::OK}));
+  histogram_tester.ExpectUniqueSample(kUIThreadTasksHistogram, 2, 1);
+}
+
+TEST_F(BraveRequestHandlerTest, AsyncResumeCompletesWithoutPostedTask) {
+  base::HistogramTester histogram_tester;
+  int calls = 0;
+  brave::ResponseCallback resume;
+
+  EXPECT_EQ(OnBeforeURLRequest(
+                {base::BindRepeating(&PendingHelper, &resume),
+                 base::BindRepeating(&CountingHelper, &calls),
+                 base::BindRepeating(&RedirectingHelper)}),
+            net::ERR_IO_PENDING);
+  EXPECT_EQ(calls, 0);
+  ASSERT_FALSE(resume.is_null());
+
+  // Resuming from the helper's own task continues the loader right away.
+  resume.Run();
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(results(), std::vector<int>({net::OK}));
+  EXPECT_EQ(new_url(), GURL("https://example.com/"));
+  EXPECT_FALSE(handler()->IsRequestIdentifierValid(kRequestIdentifier));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(results().size(), 1u);
+  histogram_tester.ExpectUniqueSample(kUIThreadTasksHistogram, 1, 1);
+}
+
+TEST_F(BraveRequestHandlerTest, AsyncResumeWithReentrantHelper) {
+  int calls = 0;
+  brave::ResponseCallback resume;
+
+  EXPECT_EQ(OnBeforeURLRequest(
+                {base::BindRepeating(&PendingHelper, &resume),
+                 base::BindRepeating(&ReentrantHelper),
+                 base::BindRepeating(&CountingHelper, &calls)}),
+            net::ERR_IO_PENDING);
+  ASSERT_FALSE(resume.is_null());
+
+  // The second helper resumes the chain inside the loop that resumed after
+  // the first one. That loop already runs in a task of its own, so the
+  // loader is continued once, without another posted task.
+  resume.Run();
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(results(), std::vector<int>({net::OK}));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(results().size(), 1u);
+}
+
+TEST_F(BraveRequestHandlerTest, AsyncResumeAfterRequestDestroyed) {
+  int calls = 0;
+  brave::ResponseCallback resume;
+
+  EXPECT_EQ(OnBeforeURLRequest(
+                {base::BindRepeating(&PendingHelper, &resume),
+                 base::BindRepeating(&CountingHelper, &calls)}),
+            net::ERR_IO_PENDING);
+  ASSERT_FALSE(resume.is_null());
+
+  auto destroyed_ctx =
+      std::make_shared<brave::BraveRequestInfo>(GURL("https://brave.com/"));
+  destroyed_ctx->request_identifier = kRequestIdentifier;
+  handler()->OnURLRequestDestroyed(destroyed_ctx);
+  EXPECT_FALSE(handler()->IsRequestIdentifierValid(kRequestIdentifier));
+
+  resume.Run();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(calls, 0);
+  EXPECT_TRUE(results().empty());
+}
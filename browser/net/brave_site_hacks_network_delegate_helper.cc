@@ -5,13 +5,13 @@
 
 #include "brave/browser/net/brave_site_hacks_network_delegate_helper.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <string>
-#include <vector>
 
-#include "base/lazy_instance.h"
+#include "base/cxx17_backports.h"
 #include "base/metrics/histogram_macros.h"
-#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
 #include "brave/common/url_constants.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
@@ -20,73 +20,88 @@
 #include "net/url_request/url_request.h"
 #include "third_party/blink/public/common/loader/network_utils.h"
 #include "third_party/blink/public/common/loader/referrer_utils.h"
-#include "third_party/re2/src/re2/re2.h"
 
 namespace brave {
 
 namespace {
 
+// Tracking query parameters, lowercase and sorted for binary search.
+constexpr const char* kQueryStringTrackers[] = {
+    // https://github.com/brave/brave-browser/issues/9019
+    "__hsfp", "__hssc", "__hstc",
+    // https://github.com/brave/brave-browser/issues/8975
+    "__s",
+    // https://github.com/brave/brave-browser/issues/9019
+    "_hsenc",
+    // https://github.com/brave/brave-browser/issues/11579
+    "_openstat",
+    // https://github.com/brave/brave-browser/issues/9879
+    "dclid",
+    // https://github.com/brave/brave-browser/issues/4239
+    "fbclid", "gclid",
+    // https://github.com/brave/brave-browser/issues/9019
+    "hsctatracking",
+    // https://github.com/brave/brave-browser/issues/4239
+    "mc_eid",
+    // https://github.com/brave/brave-browser/issues/17507
+    "ml_subscriber", "ml_subscriber_hash",
+    // https://github.com/brave/brave-browser/issues/4239
+    "msclkid",
+    // https://github.com/brave/brave-browser/issues/13644
+    "oly_anon_id", "oly_enc_id",
+    // https://github.com/brave/brave-browser/issues/17451
+    "rb_clickid",
+    // https://github.com/brave/brave-browser/issues/17452
+    "s_cid",
+    // https://github.com/brave/brave-browser/issues/11817
+    "vero_conv", "vero_id",
+    // https://github.com/brave/brave-browser/issues/13647
+    "wickedid",
+    // https://github.com/brave/brave-browser/issues/11578
+    "yclid",
+};
+
+constexpr bool IsLowercaseAndSorted(const char* const* names, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    const char* name = names[i];
+    for (size_t j = 0; name[j] != '\0'; j++) {
+      if (name[j] >= 'A' && name[j] <= 'Z')
+        return false;
+    }
+    if (i == 0)
+      continue;
+    const char* previous = names[i - 1];
+    size_t j = 0;
+    while (previous[j] != '\0' && previous[j] == name[j])
+      j++;
+    if (static_cast<unsigned char>(previous[j]) >=
+        static_cast<unsigned char>(name[j])) {
+      return false;
+    }
+  }
+  return true;
+}
 
-const std::string& GetQueryStringTrackers() {
-  static const base::NoDestructor<std::string> trackers(base::JoinString(
-      std::vector<std::string>(
-          {// https://github.com/brave/brave-browser/issues/4239
-           "fbclid", "gclid", "msclkid", "mc_eid",
-           // https://github.com/brave/brave-browser/issues/9879
-           "dclid",
-           // https://github.com/brave/brave-browser/issues/13644
-           "oly_anon_id", "oly_enc_id",
-           // https://github.com/brave/brave-browser/issues/11579
-           "_openstat",
-           // https://github.com/brave/brave-browser/issues/11817
-           "vero_conv", "vero_id",
-           // https://github.com/brave/brave-browser/issues/13647
-           "wickedid",
-           // https://github.com/brave/brave-browser/issues/11578
-           "yclid",
-           // https://github.com/brave/brave-browser/issues/8975
-           "__s",
-           // https://github.com/brave/brave-browser/issues/17451
-           "rb_clickid",
-           // https://github.com/brave/brave-browser/issues/17452
-           "s_cid",
-           // https://github.com/brave/brave-browser/issues/17507
-           "ml_subscriber", "ml_subscriber_hash",
-           // https://github.com/brave/brave-browser/issues/9019
-           "_hsenc", "__hssc", "__hstc", "__hsfp", "hsCtaTracking"}),
-      "|"));
-  return *trackers;
+static_assert(IsLowercaseAndSorted(kQueryStringTrackers,
+                                   base::size(kQueryStringTrackers)),
+              "kQueryStringTrackers must be lowercase and sorted");
+
+bool IsQueryStringTracker(base::StringPiece name) {
+  return std::binary_search(
+      std::begin(kQueryStringTrackers), std::end(kQueryStringTrackers), name,
+      [](base::StringPiece a, base::StringPiece b) {
+        return base::CompareCaseInsensitiveASCII(a, b) < 0;
+      });
 }
 
-// From src/components/autofill/content/renderer/page_passwords_analyser.cc
-// and password_form_conversion_utils.cc:
-#define DECLARE_LAZY_MATCHER(NAME, PATTERN)                                   \
-  struct LabelPatternLazyInstanceTraits_##NAME                                \
-      : public base::internal::DestructorAtExitLazyInstanceTraits<re2::RE2> { \
-    static re2::RE2* New(void* instance) {                                    \
-      re2::RE2::Options options;                                              \
-      options.set_case_sensitive(false);                                      \
-      re2::RE2* matcher = new (instance) re2::RE2(PATTERN, options);          \
-      DCHECK(matcher->ok());                                                  \
-      return matcher;                                                         \
-    }                                                                         \
-  };                                                                          \
-  base::LazyInstance<re2::RE2, LabelPatternLazyInstanceTraits_##NAME> NAME =  \
-      LAZY_INSTANCE_INITIALIZER
-
-// e.g. "?fbclid=1234"
-DECLARE_LAZY_MATCHER(tracker_only_matcher,
-                     "^(" + GetQueryStringTrackers() + ")=[^&]+$");
-
-// e.g. "?fbclid=1234&foo=1"
-DECLARE_LAZY_MATCHER(tracker_first_matcher,
-                     "^(" + GetQueryStringTrackers() + ")=[^&]+&");
-
-// e.g. "?foo=1&fbclid=1234" or "?foo=1&fbclid=1234&bar=2"
-DECLARE_LAZY_MATCHER(tracker_appended_matcher,
-                     "&(" + GetQueryStringTrackers() + ")=[^&]+");
-
-#undef DECLARE_LAZY_MATCHER
+// A parameter is a tracker if its name matches exactly and it has a value,
+// e.g. "fbclid=1234" but neither "fbclid=" nor "fbclid".
+bool IsTrackingParameter(base::StringPiece param) {
+  const size_t separator = param.find('=');
+  if (separator == base::StringPiece::npos || separator + 1 == param.size())
+    return false;
+  return IsQueryStringTracker(param.substr(0, separator));
+}
 
 void ApplyPotentialQueryStringFilter(std::shared_ptr<BraveRequestInfo> ctx) {
   SCOPED_UMA_HISTOGRAM_TIMER("Brave.SiteHacks.QueryFilter");
@@ -117,26 +132,15 @@ void ApplyPotentialQueryStringFilter(std::shared_ptr<BraveRequestInfo> ctx) {
     return;
   }
 
-  // Regular expressions are dirty and error-prone, but unfortunately
-  // there is no right way to parse a query string, other than one
-  // generated by a URL-encoded HTML form submission. See
-  // https://github.com/brave/brave-core/pull/3239#issuecomment-524073918
-  // for more information on why this approach was selected.
-
-  std::string new_query = ctx->request_url.query();
-  // Note: the ordering of these replacements is important.
-  const int replacement_count =
-      re2::RE2::GlobalReplace(&new_query, tracker_appended_matcher.Get(), "") +
-      re2::RE2::GlobalReplace(&new_query, tracker_first_matcher.Get(), "") +
-      re2::RE2::GlobalReplace(&new_query, tracker_only_matcher.Get(), "");
-
-  if (replacement_count > 0) {
+  const absl::optional<std::string> new_query =
+      StripQueryStringTrackers(ctx->request_url.query_piece());
+  if (new_query) {
     url::Replacements<char> replacements;
-    if (new_query.empty()) {
+    if (new_query->empty()) {
       replacements.ClearQuery();
     } else {
-      replacements.SetQuery(new_query.c_str(),
-                            url::Component(0, new_query.size()));
+      replacements.SetQuery(new_query->c_str(),
+                            url::Component(0, new_query->size()));
     }
     ctx->new_url_spec = ctx->request_url.ReplaceComponents(replacements).spec();
   }
@@ -165,6 +169,44 @@ bool ApplyPotentialReferrerBlock(std::shared_ptr<BraveRequestInfo> ctx) {
 
 }  // namespace
 
+// There is no right way to parse a query string other than one generated by
+// a URL-encoded HTML form submission, so parameters are only split on '&' and
+// the rest of the query is kept byte for byte. See
+// https://github.com/brave/brave-core/pull/3239#issuecomment-524073918
+absl::optional<std::string> StripQueryStringTrackers(base::StringPiece query) {
+  std::string new_query;
+  bool stripped = false;
+  bool kept_any = false;
+  size_t start = 0;
+  while (start <= query.size()) {
+    size_t end = query.find('&', start);
+    if (end == base::StringPiece::npos)
+      end = query.size();
+    const base::StringPiece param = query.substr(start, end - start);
+    if (IsTrackingParameter(param)) {
+      if (!stripped) {
+        // Everything before the first tracker is kept as is.
+        stripped = true;
+        new_query.reserve(query.size());
+        if (start > 0)
+          new_query.assign(query.data(), start - 1);
+      }
+    } else {
+      if (stripped) {
+        if (kept_any)
+          new_query.push_back('&');
+        new_query.append(param.data(), param.size());
+      }
+      kept_any = true;
+    }
+    start = end + 1;
+  }
+
+  if (!stripped)
+    return absl::nullopt;
+  return new_query;
+}
+
 int OnBeforeURLRequest_SiteHacksWork(const ResponseCallback& next_callback,
                                      std::shared_ptr<BraveRequestInfo> ctx) {
   ApplyPotentialReferrerBlock(ctx);
@@ -7,8 +7,11 @@
 #define BRAVE_BROWSER_NET_BRAVE_SITE_HACKS_NETWORK_DELEGATE_HELPER_H_
 
 #include <memory>
+#include <string>
 
+#include "base/strings/string_piece.h"
 #include "brave/browser/net/url_context.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace net {
 class URLRequest;
@@ -16,6 +19,10 @@ class URLRequest;
 
 namespace brave {
 
+// Returns |query| without its tracking parameters, or absl::nullopt if it
+// has none.
+absl::optional<std::string> StripQueryStringTrackers(base::StringPiece query);
+
 int OnBeforeURLRequest_SiteHacksWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx);
@@ -10,10 +10,12 @@
 #include <utility>
 #include <vector>
 
+#include "base/cxx17_backports.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
 #include "net/base/net_errors.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/re2/src/re2/re2.h"
 
 using brave::ResponseCallback;
 
@@ -247,3 +249,62 @@ TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryStringFiltered) {
     EXPECT_EQ(brave_request_info->new_url_spec, "https://example.com/");
   }
 }
+
+TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryStringCaseInsensitive) {
+  EXPECT_EQ("foo=1", brave::StripQueryStringTrackers("FBCLID=1&foo=1"));
+  EXPECT_EQ("foo=1", brave::StripQueryStringTrackers("foo=1&hsCtaTracking=2"));
+  EXPECT_EQ("", brave::StripQueryStringTrackers("Ml_Subscriber_Hash=3"));
+  EXPECT_FALSE(brave::StripQueryStringTrackers("ml_subscriber_has=3"));
+  EXPECT_FALSE(brave::StripQueryStringTrackers(""));
+}
+
+namespace {
+
+// The regular expressions the query filter used before it tokenized queries.
+std::string StripQueryStringTrackersWithRegex(const std::string& query) {
+  const std::string trackers =
+      "(fbclid|gclid|msclkid|mc_eid|dclid|oly_anon_id|oly_enc_id|_openstat|"
+      "vero_conv|vero_id|wickedid|yclid|__s|rb_clickid|s_cid|ml_subscriber|"
+      "ml_subscriber_hash|_hsenc|__hssc|__hstc|__hsfp|hsCtaTracking)";
+  re2::RE2::Options options;
+  options.set_case_sensitive(false);
+  static const re2::RE2 appended("&" + trackers + "=[^&]+", options);
+  static const re2::RE2 first("^" + trackers + "=[^&]+&", options);
+  static const re2::RE2 only("^" + trackers + "=[^&]+$", options);
+
+  std::string new_query = query;
+  re2::RE2::GlobalReplace(&new_query, appended, "");
+  re2::RE2::GlobalReplace(&new_query, first, "");
+  re2::RE2::GlobalReplace(&new_query, only, "");
+  return new_query;
+}
+
+}  // namespace
+
+TEST(BraveSiteHacksNetworkDelegateHelperTest, QueryStringFilterMatchesRegex) {
+  constexpr size_t kQueries = 500;
+  constexpr size_t kParamsPerQuery = 40;
+  const char* const kParams[] = {
+      "fbclid=IwAR0abcdefghijklmnopqrstuvwxyz", "utm_source=newsletter",
+      "gclid=", "id=1234567890", "=msclkid", "MSCLKID=abc", "q=a+b%20c",
+      "", "ml_subscriber_hash=xyz", "page=2", "s_cid", "a=b=c", "__s=x",
+  };
+
+  std::vector<std::string> queries;
+  queries.reserve(kQueries);
+  for (size_t i = 0; i < kQueries; i++) {
+    std::string query;
+    for (size_t j = 0; j < kParamsPerQuery; j++) {
+      if (j > 0)
+        query += '&';
+      query += kParams[(i * 7 + j * (i % 5 + 1)) % base::size(kParams)];
+    }
+    queries.push_back(std::move(query));
+  }
+
+  for (const auto& query : queries) {
+    EXPECT_EQ(brave::StripQueryStringTrackers(query).value_or(query),
+              StripQueryStringTrackersWithRegex(query))
+        << query;
+  }
+}
@@ -8,12 +8,15 @@
 #include <string>
 
 #include "brave/browser/profiles/profile_util.h"
+#include "brave/components/ipfs/ipfs_cid_cache.h"
 #include "brave/components/ipfs/ipfs_utils.h"
 #include "chrome/common/channel_info.h"
 #include "components/prefs/pref_service.h"
 #include "components/user_prefs/user_prefs.h"
 #include "content/public/browser/browser_context.h"
 #include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "url/origin.h"
 
 namespace ipfs {
 
@@ -45,6 +48,25 @@ int OnBeforeURLRequest_IPFSRedirectWork(
     } else {
       ctx->blocked_by = brave::kOtherBlocked;
     }
+    return net::OK;
+  }
+
+  // Only trusted gateways get to populate the cache, otherwise any site could
+  // plant content for a CID. Navigations keep going to the network since they
+  // need the full response handling. Cached responses skip the network
+  // service's CORS and CORB checks, so only same-origin requests, which need
+  // neither, use the cache.
+  if (ctx->method == net::HttpRequestHeaders::kGetMethod &&
+      ctx->resource_type != blink::mojom::ResourceType::kMainFrame &&
+      ctx->resource_type != blink::mojom::ResourceType::kSubFrame &&
+      url::Origin::Create(ctx->initiator_url)
+          .IsSameOriginWith(url::Origin::Create(ctx->request_url)) &&
+      ((IsLocalGatewayURL(ctx->request_url) &&
+        ctx->request_url.EffectiveIntPort() ==
+            ctx->ipfs_gateway_url.EffectiveIntPort()) ||
+       IsDefaultGatewayURL(ctx->request_url, prefs))) {
+    ctx->ipfs_cache_key = IpfsCidCache::MakeKey(
+        url::Origin::Create(ctx->tab_origin), ctx->request_url);
   }
   return net::OK;
 }
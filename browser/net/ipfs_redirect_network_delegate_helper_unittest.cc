@@ -204,6 +204,38 @@ TEST_F(IPFSRedirectNetworkDelegateHelperTest, HeadersIPFSWorkNoRedirect) {
   EXPECT_TRUE(allowed_unsafe_redirect_url.is_empty());
 }
 
+TEST_F(IPFSRedirectNetworkDelegateHelperTest, CidCacheKey) {
+  GURL url(
+      "https://dweb.link/ipfs/QmfM2r8seH2GiRaC4esTjeraXEachRt8ZsSeGaWTPLyMoG/"
+      "a.png");
+  auto request_info = std::make_shared<brave::BraveRequestInfo>(url);
+  request_info->browser_context = profile();
+  request_info->method = "GET";
+  request_info->resource_type = blink::mojom::ResourceType::kImage;
+  request_info->ipfs_gateway_url = GetPublicGateway();
+  request_info->initiator_url = GURL(
+      "https://dweb.link/ipfs/QmfM2r8seH2GiRaC4esTjeraXEachRt8ZsSeGaWTPLyMoG/");
+  request_info->tab_origin = GURL("https://a.com/");
+  int rc = ipfs::OnBeforeURLRequest_IPFSRedirectWork(brave::ResponseCallback(),
+                                                     request_info);
+  EXPECT_EQ(rc, net::OK);
+  EXPECT_EQ(request_info->ipfs_cache_key,
+            "https://a.com " + GetImmutableIPFSCacheKey(url));
+
+  // Cross-origin requests would need CORS and CORB checks the cache skips.
+  request_info = std::make_shared<brave::BraveRequestInfo>(url);
+  request_info->browser_context = profile();
+  request_info->method = "GET";
+  request_info->resource_type = blink::mojom::ResourceType::kImage;
+  request_info->ipfs_gateway_url = GetPublicGateway();
+  request_info->initiator_url = GURL("https://a.com/");
+  request_info->tab_origin = GURL("https://a.com/");
+  rc = ipfs::OnBeforeURLRequest_IPFSRedirectWork(brave::ResponseCallback(),
+                                                 request_info);
+  EXPECT_EQ(rc, net::OK);
+  EXPECT_TRUE(request_info->ipfs_cache_key.empty());
+}
+
 TEST_F(IPFSRedirectNetworkDelegateHelperTest, PrivateProfile) {
   GURL url("ipfs://QmfM2r8seH2GiRaC4esTjeraXEachRt8ZsSeGaWTPLyMoG");
   auto brave_request_info = std::make_shared<brave::BraveRequestInfo>(url);
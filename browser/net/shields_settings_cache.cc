@@ -0,0 +1,88 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/shields_settings_cache.h"
+
+#include <memory>
+
+#include "base/memory/ptr_util.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
+
+namespace brave {
+
+namespace {
+
+// User data key for ShieldsSettingsCache.
+const void* const kShieldsSettingsCacheUserDataKey =
+    &kShieldsSettingsCacheUserDataKey;
+
+// Enough for every top frame origin of a busy session.
+constexpr size_t kMaxCachedOrigins = 64;
+
+}  // namespace
+
+ShieldsSettingsCache::ShieldsSettingsCache(HostContentSettingsMap* map)
+    : map_(map), settings_(kMaxCachedOrigins) {
+  observation_.Observe(map);
+}
+
+ShieldsSettingsCache::~ShieldsSettingsCache() = default;
+
+// static
+ShieldsSettingsCache* ShieldsSettingsCache::FromBrowserContext(
+    content::BrowserContext* browser_context) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  auto* self = static_cast<ShieldsSettingsCache*>(
+      browser_context->GetUserData(kShieldsSettingsCacheUserDataKey));
+  if (!self) {
+    self = new ShieldsSettingsCache(
+        HostContentSettingsMapFactory::GetForProfile(
+            Profile::FromBrowserContext(browser_context)));
+    browser_context->SetUserData(kShieldsSettingsCacheUserDataKey,
+                                 base::WrapUnique(self));
+  }
+  return self;
+}
+
+const ShieldsSettings& ShieldsSettingsCache::Get(const GURL& url) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  // Shields content settings are keyed by host, so the origin is enough.
+  const GURL origin = url.GetOrigin();
+  auto it = settings_.Get(origin);
+  if (it != settings_.end())
+    return it->second;
+
+  ShieldsSettings settings;
+  HostContentSettingsMap* map = map_.get();
+  settings.shields_enabled = brave_shields::GetBraveShieldsEnabled(map, origin);
+  settings.allow_ads = brave_shields::GetAdControlType(map, origin) ==
+                       brave_shields::ControlType::ALLOW;
+  // Currently, "aggressive" mode is registered as a cosmetic filtering control
+  // type, even though it can also affect network blocking.
+  settings.aggressive_blocking =
+      brave_shields::GetCosmeticFilteringControlType(map, origin) ==
+      brave_shields::ControlType::BLOCK;
+  settings.https_everywhere_enabled =
+      brave_shields::GetHTTPSEverywhereEnabled(map, origin);
+  settings.allow_referrers = brave_shields::AllowReferrers(map, origin);
+
+  return settings_.Put(origin, settings)->second;
+}
+
+void ShieldsSettingsCache::OnContentSettingChanged(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsType content_type) {
+  // Changes are rare, so don't bother working out which origins they touch.
+  settings_.Clear();
+}
+
+}  // namespace brave
@@ -0,0 +1,69 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_SHIELDS_SETTINGS_CACHE_H_
+#define BRAVE_BROWSER_NET_SHIELDS_SETTINGS_CACHE_H_
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/scoped_observation.h"
+#include "base/supports_user_data.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "url/gurl.h"
+
+namespace content {
+class BrowserContext;
+}
+
+namespace brave {
+
+// Shields settings that apply to requests made from a top frame origin.
+struct ShieldsSettings {
+  bool shields_enabled = true;
+  bool allow_ads = false;
+  bool aggressive_blocking = false;
+  bool https_everywhere_enabled = true;
+  bool allow_referrers = false;
+};
+
+// Snapshots the shields settings of recently seen top frame origins, so that
+// building a BraveRequestInfo for each stage of each subresource request
+// doesn't query HostContentSettingsMap again. The snapshot is dropped
+// whenever a content setting of the profile changes. There is one cache per
+// profile.
+class ShieldsSettingsCache : public base::SupportsUserData::Data,
+                             public content_settings::Observer {
+ public:
+  ~ShieldsSettingsCache() override;
+
+  ShieldsSettingsCache(const ShieldsSettingsCache&) = delete;
+  ShieldsSettingsCache& operator=(const ShieldsSettingsCache&) = delete;
+
+  static ShieldsSettingsCache* FromBrowserContext(
+      content::BrowserContext* browser_context);
+
+  // Returns the settings for the origin of |url|.
+  const ShieldsSettings& Get(const GURL& url);
+
+  size_t size_for_testing() const { return settings_.size(); }
+
+ private:
+  explicit ShieldsSettingsCache(HostContentSettingsMap* map);
+
+  // content_settings::Observer:
+  void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
+                               const ContentSettingsPattern& secondary_pattern,
+                               ContentSettingsType content_type) override;
+
+  scoped_refptr<HostContentSettingsMap> map_;
+  base::MRUCache<GURL, ShieldsSettings> settings_;
+  base::ScopedObservation<HostContentSettingsMap, content_settings::Observer>
+      observation_{this};
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_SHIELDS_SETTINGS_CACHE_H_
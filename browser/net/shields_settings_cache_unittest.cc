@@ -0,0 +1,85 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/shields_settings_cache.h"
+
+#include <memory>
+
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+class ShieldsSettingsCacheTest : public testing::Test {
+ public:
+  ShieldsSettingsCacheTest() = default;
+  ~ShieldsSettingsCacheTest() override = default;
+
+  void SetUp() override { profile_ = std::make_unique<TestingProfile>(); }
+
+  TestingProfile* profile() { return profile_.get(); }
+  HostContentSettingsMap* map() {
+    return HostContentSettingsMapFactory::GetForProfile(profile());
+  }
+  ShieldsSettingsCache* cache() {
+    return ShieldsSettingsCache::FromBrowserContext(profile());
+  }
+
+ private:
+  content::BrowserTaskEnvironment task_environment_;
+  std::unique_ptr<TestingProfile> profile_;
+};
+
+TEST_F(ShieldsSettingsCacheTest, SnapshotsPerOrigin) {
+  EXPECT_EQ(cache(), ShieldsSettingsCache::FromBrowserContext(profile()));
+
+  const GURL url("https://brave.com/");
+  EXPECT_TRUE(cache()->Get(url).shields_enabled);
+  EXPECT_EQ(1u, cache()->size_for_testing());
+
+  // Paths of the same origin share a snapshot.
+  EXPECT_TRUE(cache()->Get(GURL("https://brave.com/a/b.html")).shields_enabled);
+  EXPECT_EQ(1u, cache()->size_for_testing());
+
+  cache()->Get(GURL("https://example.com/"));
+  EXPECT_EQ(2u, cache()->size_for_testing());
+}
+
+TEST_F(ShieldsSettingsCacheTest, MatchesContentSettings) {
+  const GURL url("https://brave.com/");
+  const ShieldsSettings& settings = cache()->Get(url);
+  EXPECT_EQ(brave_shields::GetBraveShieldsEnabled(map(), url),
+            settings.shields_enabled);
+  EXPECT_EQ(brave_shields::GetAdControlType(map(), url) ==
+                brave_shields::ControlType::ALLOW,
+            settings.allow_ads);
+  EXPECT_EQ(brave_shields::GetCosmeticFilteringControlType(map(), url) ==
+                brave_shields::ControlType::BLOCK,
+            settings.aggressive_blocking);
+  EXPECT_EQ(brave_shields::GetHTTPSEverywhereEnabled(map(), url),
+            settings.https_everywhere_enabled);
+  EXPECT_EQ(brave_shields::AllowReferrers(map(), url),
+            settings.allow_referrers);
+}
+
+TEST_F(ShieldsSettingsCacheTest, InvalidatedOnContentSettingChange) {
+  const GURL url("https://brave.com/");
+  EXPECT_TRUE(cache()->Get(url).shields_enabled);
+  EXPECT_FALSE(cache()->Get(url).allow_ads);
+
+  brave_shields::SetBraveShieldsEnabled(map(), false, url);
+  EXPECT_EQ(0u, cache()->size_for_testing());
+  EXPECT_FALSE(cache()->Get(url).shields_enabled);
+
+  brave_shields::SetAdControlType(map(), brave_shields::ControlType::ALLOW,
+                                  url);
+  EXPECT_TRUE(cache()->Get(url).allow_ads);
+}
+
+}  // namespace brave
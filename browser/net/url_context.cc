@@ -9,12 +9,10 @@
 #include <string>
 
 #include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
-#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "brave/browser/net/shields_settings_cache.h"
 #include "brave/components/brave_webtorrent/browser/buildflags/buildflags.h"
 #include "brave/components/brave_webtorrent/browser/webtorrent_util.h"
 #include "brave/components/ipfs/buildflags/buildflags.h"
-#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
-#include "chrome/browser/profiles/profile.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/isolation_info.h"
 #include "services/network/public/cpp/resource_request.h"
@@ -30,32 +28,26 @@
 
 namespace brave {
 
-namespace {
+BraveRequestInfo::BraveRequestInfo() = default;
+
+BraveRequestInfo::BraveRequestInfo(const GURL& url) : request_url(url) {}
+
+BraveRequestInfo::~BraveRequestInfo() = default;
 
-std::string GetUploadData(const network::ResourceRequest& request) {
+std::string BraveRequestInfo::GetUploadData() const {
   std::string upload_data;
-  if (!request.request_body) {
-    return {};
-  }
-  const auto* elements = request.request_body->elements();
-  for (const network::DataElement& element : *elements) {
+  if (!request_body)
+    return upload_data;
+
+  for (const network::DataElement& element : *request_body->elements()) {
     if (element.type() == network::mojom::DataElementDataView::Tag::kBytes) {
       const auto& bytes = element.As<network::DataElementBytes>().bytes();
       upload_data.append(bytes.begin(), bytes.end());
     }
   }
-
   return upload_data;
 }
 
-}  // namespace
-
-BraveRequestInfo::BraveRequestInfo() = default;
-
-BraveRequestInfo::BraveRequestInfo(const GURL& url) : request_url(url) {}
-
-BraveRequestInfo::~BraveRequestInfo() = default;
-
 // static
 std::shared_ptr<brave::BraveRequestInfo> BraveRequestInfo::MakeCTX(
     const network::ResourceRequest& request,
@@ -133,28 +125,24 @@ std::shared_ptr<brave::BraveRequestInfo> BraveRequestInfo::MakeCTX(
   }
 #endif
 
-  Profile* profile = Profile::FromBrowserContext(browser_context);
-  auto* map = HostContentSettingsMapFactory::GetForProfile(profile);
-  ctx->allow_brave_shields =
-      brave_shields::GetBraveShieldsEnabled(map, ctx->tab_origin);
-  ctx->allow_ads = brave_shields::GetAdControlType(map, ctx->tab_origin) ==
-                   brave_shields::ControlType::ALLOW;
-  // Currently, "aggressive" mode is registered as a cosmetic filtering control
-  // type, even though it can also affect network blocking.
-  ctx->aggressive_blocking =
-      brave_shields::GetCosmeticFilteringControlType(map, ctx->tab_origin) ==
-      brave_shields::ControlType::BLOCK;
-  ctx->allow_http_upgradable_resource =
-      !brave_shields::GetHTTPSEverywhereEnabled(map, ctx->tab_origin);
+  auto* shields_settings_cache =
+      ShieldsSettingsCache::FromBrowserContext(browser_context);
+  const ShieldsSettings settings =
+      shields_settings_cache->Get(ctx->tab_origin);
+  ctx->allow_brave_shields = settings.shields_enabled;
+  ctx->allow_ads = settings.allow_ads;
+  ctx->aggressive_blocking = settings.aggressive_blocking;
+  ctx->allow_http_upgradable_resource = !settings.https_everywhere_enabled;
 
   // HACK: after we fix multiple creations of BraveRequestInfo we should
   // use only tab_origin. Since we recreate BraveRequestInfo during consequent
   // stages of navigation, |tab_origin| changes and so does |allow_referrers|
   // flag, which is not what we want for determining referrers.
-  ctx->allow_referrers = brave_shields::AllowReferrers(
-      map,
-      ctx->redirect_source.is_empty() ? ctx->tab_origin : ctx->redirect_source);
-  ctx->upload_data = GetUploadData(request);
+  ctx->allow_referrers =
+      ctx->redirect_source.is_empty()
+          ? settings.allow_referrers
+          : shields_settings_cache->Get(ctx->redirect_source).allow_referrers;
+  ctx->request_body = request.request_body;
 
   ctx->browser_context = browser_context;
 
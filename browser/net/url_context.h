@@ -10,10 +10,12 @@
 #include <set>
 #include <string>
 
+#include "base/time/time.h"
 #include "net/base/network_isolation_key.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 #include "net/url_request/referrer_policy.h"
+#include "services/network/public/cpp/resource_request_body.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 #include "url/gurl.h"
@@ -101,6 +103,10 @@ struct BraveRequestInfo {
   std::string mock_data_url;
   GURL ipfs_gateway_url;
   bool ipfs_auto_fallback = false;
+  // Set for same-origin immutable subresources loaded from the local node or
+  // the configured gateway, which may be answered from the IPFS CID cache.
+  // See ipfs::IpfsCidCache::MakeKey().
+  std::string ipfs_cache_key;
 
   bool ShouldMockRequest() const { return !mock_data_url.empty(); }
 
@@ -114,7 +120,12 @@ struct BraveRequestInfo {
       static_cast<blink::mojom::ResourceType>(-1);
   blink::mojom::ResourceType resource_type = kInvalidResourceType;
 
-  std::string upload_data;
+  // Body of the request, shared with the request rather than copied.
+  scoped_refptr<network::ResourceRequestBody> request_body;
+
+  // Returns a copy of the in-memory parts of |request_body|. Only call this
+  // for requests that are actually inspected, as bodies can be large.
+  std::string GetUploadData() const;
 
   static std::shared_ptr<brave::BraveRequestInfo> MakeCTX(
       const network::ResourceRequest& request,
@@ -131,6 +142,11 @@ struct BraveRequestInfo {
 
   GURL* new_url = nullptr;
 
+  // Bookkeeping for the current interception stage.
+  base::TimeTicks interception_start_time;
+  int interception_ui_tasks = 0;
+  bool in_synchronous_dispatch = false;
+
   DISALLOW_COPY_AND_ASSIGN(BraveRequestInfo);
 };
 
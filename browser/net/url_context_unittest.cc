@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/url_context.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "chrome/test/base/testing_profile.h"
+#include "content/public/test/browser_task_environment.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/resource_request_body.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+class BraveRequestInfoTest : public testing::Test {
+ public:
+  BraveRequestInfoTest() = default;
+  ~BraveRequestInfoTest() override = default;
+
+  void SetUp() override { profile_ = std::make_unique<TestingProfile>(); }
+
+  std::shared_ptr<BraveRequestInfo> MakeCTX(
+      const network::ResourceRequest& request) {
+    return BraveRequestInfo::MakeCTX(request, 0, 0, 1, profile_.get(),
+                                     nullptr);
+  }
+
+ private:
+  content::BrowserTaskEnvironment task_environment_;
+  std::unique_ptr<TestingProfile> profile_;
+};
+
+TEST_F(BraveRequestInfoTest, UploadDataIsNotCopied) {
+  network::ResourceRequest request;
+  request.method = "POST";
+  request.url = GURL("https://brave.com/upload");
+  request.request_body = base::MakeRefCounted<network::ResourceRequestBody>();
+  const std::vector<char> body(1024, 'x');
+  request.request_body->AppendBytes(body.data(), body.size());
+
+  auto ctx = MakeCTX(request);
+  ASSERT_EQ(request.request_body, ctx->request_body);
+  const auto& element = ctx->request_body->elements()->front();
+  EXPECT_EQ(request.request_body->elements()->front()
+                .As<network::DataElementBytes>()
+                .bytes()
+                .data(),
+            element.As<network::DataElementBytes>().bytes().data());
+
+  // Every stage of the request shares the same body.
+  auto next_ctx = BraveRequestInfo::MakeCTX(request, 0, 0, 1,
+                                            ctx->browser_context, ctx);
+  EXPECT_EQ(ctx->request_body, next_ctx->request_body);
+}
+
+TEST_F(BraveRequestInfoTest, GetUploadData) {
+  network::ResourceRequest request;
+  request.method = "POST";
+  request.url = GURL("https://brave.com/upload");
+  EXPECT_EQ("", MakeCTX(request)->GetUploadData());
+
+  request.request_body = base::MakeRefCounted<network::ResourceRequestBody>();
+  request.request_body->AppendBytes("foo", 3);
+  request.request_body->AppendBytes("bar", 3);
+  EXPECT_EQ("foobar", MakeCTX(request)->GetUploadData());
+}
+
+}  // namespace brave
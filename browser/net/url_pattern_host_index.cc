@@ -0,0 +1,54 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/url_pattern_host_index.h"
+
+#include "base/strings/string_piece.h"
+#include "extensions/common/url_pattern.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+URLPatternHostIndex::URLPatternHostIndex(
+    const std::vector<const URLPattern*>& patterns) {
+  for (const URLPattern* pattern : patterns) {
+    if (pattern->host().empty()) {
+      matches_all_hosts_ = true;
+      continue;
+    }
+    hosts_.insert(pattern->host());
+    if (pattern->match_subdomains())
+      subdomain_hosts_.insert(pattern->host());
+  }
+}
+
+URLPatternHostIndex::~URLPatternHostIndex() = default;
+
+bool URLPatternHostIndex::MayMatch(const GURL& url) const {
+  // Nested URLs are matched against their inner URL; leave those to the
+  // patterns.
+  if (matches_all_hosts_ || url.inner_url())
+    return true;
+
+  base::StringPiece host = url.host_piece();
+  // URLPattern ignores a trailing dot.
+  if (!host.empty() && host.back() == '.')
+    host.remove_suffix(1);
+
+  if (hosts_.find(host) != hosts_.end())
+    return true;
+
+  while (!subdomain_hosts_.empty()) {
+    if (subdomain_hosts_.find(host) != subdomain_hosts_.end())
+      return true;
+    const size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+  return false;
+}
+
+}  // namespace brave
@@ -0,0 +1,44 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_URL_PATTERN_HOST_INDEX_H_
+#define BRAVE_BROWSER_NET_URL_PATTERN_HOST_INDEX_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+
+class GURL;
+class URLPattern;
+
+namespace brave {
+
+// Indexes the hosts of a set of URLPatterns, so that URLs on unrelated hosts
+// can be told apart with a few set lookups before matching the patterns one
+// by one.
+class URLPatternHostIndex {
+ public:
+  explicit URLPatternHostIndex(const std::vector<const URLPattern*>& patterns);
+  ~URLPatternHostIndex();
+
+  URLPatternHostIndex(const URLPatternHostIndex&) = delete;
+  URLPatternHostIndex& operator=(const URLPatternHostIndex&) = delete;
+
+  // Returns false if none of the patterns can match |url|. A true result
+  // still needs the patterns to be checked.
+  bool MayMatch(const GURL& url) const;
+
+ private:
+  base::flat_set<std::string, std::less<>> hosts_;
+  // Hosts of patterns that also match their subdomains.
+  base::flat_set<std::string, std::less<>> subdomain_hosts_;
+  bool matches_all_hosts_ = false;
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_URL_PATTERN_HOST_INDEX_H_
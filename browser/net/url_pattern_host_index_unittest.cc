@@ -0,0 +1,158 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/url_pattern_host_index.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "brave/common/network_constants.h"
+#include "extensions/common/url_pattern.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+constexpr int kSchemes = URLPattern::SCHEME_HTTP | URLPattern::SCHEME_HTTPS;
+
+// The patterns used by the static and common static redirect helpers.
+std::vector<URLPattern> GetRedirectPatterns() {
+  return {
+      URLPattern(kSchemes, kGeoLocationsPattern),
+      URLPattern(kSchemes, kSafeBrowsingPrefix),
+      URLPattern(kSchemes, kSafeBrowsingFileCheckPrefix),
+      URLPattern(kSchemes, kSafeBrowsingCrxListPrefix),
+      URLPattern(kSchemes, kCRLSetPrefix1),
+      URLPattern(kSchemes, kCRLSetPrefix2),
+      URLPattern(kSchemes, kCRLSetPrefix3),
+      URLPattern(kSchemes, kCRLSetPrefix4),
+      URLPattern(kSchemes, kCRXDownloadPrefix),
+      URLPattern(kSchemes, kAutofillPrefix),
+      URLPattern(kSchemes, "*://*.gvt1.com/*"),
+      URLPattern(kSchemes, "*://dl.google.com/*"),
+      URLPattern(kSchemes, kChromeCastPrefix),
+      URLPattern(kSchemes, kClients4Prefix),
+      URLPattern(kSchemes, "*://bugs.chromium.org/p/chromium/issues/entry?*"),
+  };
+}
+
+std::vector<const URLPattern*> ToPointers(
+    const std::vector<URLPattern>& patterns) {
+  std::vector<const URLPattern*> pointers;
+  for (const URLPattern& pattern : patterns)
+    pointers.push_back(&pattern);
+  return pointers;
+}
+
+bool AnyPatternMatches(const std::vector<URLPattern>& patterns,
+                       const GURL& url) {
+  return std::any_of(patterns.begin(), patterns.end(),
+                     [&url](const URLPattern& pattern) {
+                       return pattern.MatchesURL(url) ||
+                              pattern.MatchesHost(url);
+                     });
+}
+
+// URLs from the redirect helper unit tests, plus near misses.
+const char* const kCorpus[] = {
+    "https://bradhatesprimes.brave.com/composite_numbers_ftw",
+    "https://www.googleapis.com/geolocation/v1/geolocate?key=2_3_5_7",
+    "https://dl.google.com/release2/chrome_component/AJ4r388iQSJq_4819/"
+    "4819_all_crl-set-5934829738003798040.data.crx3",
+    "https://r2---sn-8xgp1vo-qxoe.gvt1.com/edgedl/release2/chrome_component/"
+    "AJ4r388iQSJq_4819/4819_all_crl-set-5934829738003798040.data.crx3",
+    "https://www.google.com/dl/release2/chrome_component/LLjIBPPmveI_4988/"
+    "4988_all_crl-set-6296993568184466307.data.crx3",
+    "http://clients2.googleusercontent.com/crx/blobs/QgAAAC6zw0qH2DJtn"
+    "Xe8Z7rUJP1RM6lX7kVcwkQ56ujmG3AWYOAkxoNnIdnEBUz_3z4keVhjzzAF10srsaL7"
+    "lrntfBIflcYIrTziwX3SUS9i_P-CAMZSmuV5tdQl-Roo6cnVC_GRzKsnZSKm1Q/"
+    "extension_2_0_673_0.crx",
+    "https://safebrowsing.googleapis.com/v4/threatListUpdates:fetch?"
+    "$req=ChkKCGNo",
+    "https://sb-ssl.google.com/safebrowsing/clientreport/download?key=DUMMY",
+    "https://safebrowsing.google.com/safebrowsing/clientreport/"
+    "crx-list-info?key=DUMMY",
+    "https://www.gstatic.com/autofill/hourly/bins.js",
+    "http://redirector.gvt1.com/edgedl/widevine-cdm/4.10.1610.0-win-x64.zip",
+    "http://dl.google.com/edgedl/widevine-cdm/4.10.1610.0-win-x64.zip",
+    "http://gvt1.com/foo",
+    "http://a.b.c.gvt1.com/foo",
+    "http://gvt1.com./foo",
+    "http://redirector.gvt1.com./edgedl/foo",
+    "http://evilgvt1.com/foo",
+    "http://gvt1.com.evil.com/foo",
+    "https://dl.google.com./release2/chrome_component/x_crl-set-1",
+    "https://clients4.google.com/",
+    "https://clients4.google.com/chrome-sync/dev",
+    "https://clients4.google.com:8443/",
+    "https://bugs.chromium.org/p/chromium/issues/entry?comment=foo",
+    "https://update.googleapis.com/service/update2/json?foo=bar",
+    "https://storage.googleapis.com/update-delta/"
+    "hfnkpimlhhgieaddgfemjhofmfblmnib/1234/5678.crxd",
+    "https://GOOGLE.com/",
+    "https://www.example.com/",
+    "https://1.2.3.4/",
+    "https://[::1]/",
+    "filesystem:https://dl.google.com/temporary/foo",
+    "filesystem:https://example.com/temporary/foo",
+    "blob:https://dl.google.com/1234",
+    "data:text/plain,hello",
+    "about:blank",
+    "chrome://settings",
+    "file:///etc/passwd",
+};
+
+}  // namespace
+
+TEST(URLPatternHostIndexTest, NeverRejectsMatchingURLs) {
+  const std::vector<URLPattern> patterns = GetRedirectPatterns();
+  const brave::URLPatternHostIndex index(ToPointers(patterns));
+
+  for (const char* spec : kCorpus) {
+    const GURL url(spec);
+    if (AnyPatternMatches(patterns, url))
+      EXPECT_TRUE(index.MayMatch(url)) << spec;
+  }
+}
+
+TEST(URLPatternHostIndexTest, RejectsUnrelatedHosts) {
+  const std::vector<URLPattern> patterns = GetRedirectPatterns();
+  const brave::URLPatternHostIndex index(ToPointers(patterns));
+
+  EXPECT_FALSE(index.MayMatch(GURL("https://www.example.com/")));
+  EXPECT_FALSE(index.MayMatch(GURL("http://evilgvt1.com/foo")));
+  EXPECT_FALSE(index.MayMatch(GURL("http://gvt1.com.evil.com/foo")));
+  EXPECT_FALSE(index.MayMatch(GURL("https://mail.google.com/")));
+  EXPECT_FALSE(index.MayMatch(GURL("data:text/plain,hello")));
+
+  EXPECT_TRUE(index.MayMatch(GURL("http://gvt1.com/foo")));
+  EXPECT_TRUE(index.MayMatch(GURL("http://a.b.c.gvt1.com./foo")));
+  EXPECT_TRUE(index.MayMatch(GURL("https://dl.google.com/")));
+  EXPECT_FALSE(index.MayMatch(GURL("https://a.dl.google.com/")));
+}
+
+TEST(URLPatternHostIndexTest, PatternWithoutHostMatchesAll) {
+  const URLPattern all_urls(kSchemes, "<all_urls>");
+  const URLPattern any_host(kSchemes, "*://*/foo");
+  EXPECT_TRUE(brave::URLPatternHostIndex({&all_urls})
+                  .MayMatch(GURL("https://www.example.com/")));
+  EXPECT_TRUE(brave::URLPatternHostIndex({&any_host})
+                  .MayMatch(GURL("https://www.example.com/")));
+}
+
+TEST(URLPatternHostIndexTest, RejectsOnlyNonMatchingGeneratedURLs) {
+  constexpr size_t kURLs = 1000;
+  const std::vector<URLPattern> patterns = GetRedirectPatterns();
+  const brave::URLPatternHostIndex index(ToPointers(patterns));
+
+  for (size_t i = 0; i < kURLs; i++) {
+    const GURL url(base::StringPrintf(
+        "https://cdn%zu.site%zu.example/assets/%zu.js", i % 7, i % 113, i));
+    EXPECT_FALSE(AnyPatternMatches(patterns, url)) << url;
+    EXPECT_FALSE(index.MayMatch(url)) << url;
+  }
+}
@@ -12,6 +12,7 @@
 #include "base/values.h"
 #include "brave/browser/autocomplete/brave_autocomplete_scheme_classifier.h"
 #include "brave/common/pref_names.h"
+#include "brave/components/tor/buildflags/buildflags.h"
 #include "brave/components/weekly_storage/weekly_storage.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/ui/omnibox/chrome_omnibox_client.h"
@@ -20,6 +21,11 @@
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
 
+#if BUILDFLAG(ENABLE_TOR)
+#include "brave/browser/tor/tor_profile_service_factory.h"
+#include "brave/components/tor/tor_profile_service.h"
+#endif
+
 namespace {
 
 constexpr char kSearchCountPrefName[] = "brave.weekly_storage.search_count";
@@ -90,3 +96,24 @@ void BraveOmniboxClientImpl::OnInputAccepted(const AutocompleteMatch& match) {
     RecordSearchEventP3A(storage.GetWeeklySum());
   }
 }
+
+void BraveOmniboxClientImpl::OnTextChanged(
+    const AutocompleteMatch& current_match,
+    bool user_input_in_progress,
+    const std::u16string& user_text,
+    const AutocompleteResult& result,
+    bool has_focus) {
+#if BUILDFLAG(ENABLE_TOR)
+  // Tor windows don't preconnect, but a clean circuit for the likely
+  // destination still saves a circuit build on the first load.
+  if (profile_->IsTor() && user_input_in_progress &&
+      current_match.destination_url.is_valid()) {
+    tor::TorProfileService* service =
+        TorProfileServiceFactory::GetForContext(profile_);
+    if (service)
+      service->PrewarmCircuit(current_match.destination_url);
+  }
+#endif
+  ChromeOmniboxClient::OnTextChanged(current_match, user_input_in_progress,
+                                     user_text, result, has_focus);
+}
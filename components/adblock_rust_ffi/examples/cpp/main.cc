@@ -209,6 +209,34 @@ void TestRedirect() {
         false, "image");
 }
 
+void TestSharedResources() {
+  adblock::Engine engine("-advertisement-$redirect=1x1-transparent.gif\n");
+  adblock::Engine other_engine(
+      "-advertisement-$redirect=1x1-transparent.gif\n");
+  {
+    adblock::Resources resources(
+        "[{\"name\": \"1x1-transparent.gif\","
+        "\"aliases\": [],"
+        "\"kind\": {\"mime\": \"image/gif\"},"
+        "\"content\":"
+        "\"R0lGODlhAQABAAAAACH5BAEKAAEALAAAAAABAAEAAAICTAEAOw==\"}]");
+    engine.useResources(resources);
+    other_engine.useResources(resources);
+  }
+  Check(true, false, false,
+        "data:image/"
+        "gif;base64,R0lGODlhAQABAAAAACH5BAEKAAEALAAAAAABAAEAAAICTAEAOw==",
+        "Testing shared resources redirect match", &engine,
+        "http://example.com/-advertisement-icon.", "example.com", "example.com",
+        false, "image");
+  Check(true, false, false,
+        "data:image/"
+        "gif;base64,R0lGODlhAQABAAAAACH5BAEKAAEALAAAAAABAAEAAAICTAEAOw==",
+        "Testing shared resources redirect match in other engine",
+        &other_engine, "http://example.com/-advertisement-icon.",
+        "example.com", "example.com", false, "image");
+}
+
 void TestThirdParty() {
   adblock::Engine engine("-advertisement-icon$third-party");
   Check(true, false, false, "", "Without needed tags", &engine,
@@ -430,6 +458,7 @@ int main() {
   TestTags();
   TestRedirects();
   TestRedirect();
+  TestSharedResources();
   TestThirdParty();
   TestImportant();
   TestException();
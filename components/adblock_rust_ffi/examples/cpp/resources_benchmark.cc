@@ -0,0 +1,100 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Compares the resident memory of engines which each parse and keep their
+// own copy of the resources JSON, like every adblock service used to, with
+// engines which all use a single parsed `adblock::Resources`.
+//
+// Usage: resources_benchmark.out <per-engine|shared> <engine count>
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "wrapper.h"
+
+namespace {
+
+// Roughly the size of the scriptlet and redirect resources shipped with the
+// default adblock component.
+const size_t kResourceCount = 250;
+const size_t kResourceContentSize = 2048;
+
+std::string BuildResourcesJson() {
+  std::string content;
+  while (content.size() < kResourceContentSize) {
+    content += "QUFB";
+  }
+
+  std::string json = "[";
+  for (size_t i = 0; i < kResourceCount; i++) {
+    if (i > 0) {
+      json += ",";
+    }
+    json += "{\"name\": \"resource" + std::to_string(i) +
+            ".js\", \"aliases\": [], \"kind\": {\"mime\": "
+            "\"application/javascript\"}, \"content\": \"" +
+            content + "\"}";
+  }
+  json += "]";
+  return json;
+}
+
+size_t GetResidentSetSizeInKiB() {
+  std::ifstream statm("/proc/self/statm");
+  size_t size = 0;
+  size_t resident = 0;
+  statm >> size >> resident;
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void DomainResolver(const char* host, uint32_t* start, uint32_t* end) {
+  *start = 0;
+  *end = strlen(host);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    std::cout << "Usage: " << argv[0] << " <per-engine|shared> <engine count>"
+              << std::endl;
+    return 1;
+  }
+
+  const bool shared = !strcmp(argv[1], "shared");
+  const size_t engine_count = strtoul(argv[2], nullptr, 10);
+
+  adblock::SetDomainResolver(DomainResolver);
+
+  std::unique_ptr<std::string> json(new std::string(BuildResourcesJson()));
+  const size_t baseline = GetResidentSetSizeInKiB();
+
+  std::vector<std::unique_ptr<adblock::Engine>> engines;
+  std::vector<std::string> per_engine_json;
+  std::unique_ptr<adblock::Resources> resources;
+  if (shared) {
+    resources.reset(new adblock::Resources(*json));
+  }
+
+  for (size_t i = 0; i < engine_count; i++) {
+    engines.emplace_back(new adblock::Engine("||example.com^\n"));
+    if (shared) {
+      engines.back()->useResources(*resources);
+    } else {
+      per_engine_json.push_back(*json);
+      engines.back()->addResources(per_engine_json.back());
+    }
+  }
+
+  std::cout << argv[1] << " " << engine_count << " engines: "
+            << GetResidentSetSizeInKiB() - baseline << " KiB" << std::endl;
+  return 0;
+}
@@ -16,6 +16,12 @@
  */
 typedef struct C_Engine C_Engine;
 
+/**
+ * A list of `Resource`s parsed once so that it can be used by any number of
+ * engines.
+ */
+typedef struct C_Resources C_Resources;
+
 /**
  * An external callback that receives a hostname and two out-parameters for
  * start and end position. The callback should fill the start and end positions
@@ -92,6 +98,22 @@ bool engine_add_resource(struct C_Engine* engine,
  */
 void engine_add_resources(struct C_Engine* engine, const char* resources);
 
+/**
+ * Parses a list of `Resource`s from JSON format
+ */
+struct C_Resources* resources_create(const char* resources);
+
+/**
+ * Uses previously parsed `Resources` in the engine
+ */
+void engine_use_resources(struct C_Engine* engine,
+                          const struct C_Resources* resources);
+
+/**
+ * Destroy `Resources` once you are done with them.
+ */
+void resources_destroy(struct C_Resources* resources);
+
 /**
  * Removes a tag to the engine for consideration
  */
@@ -187,19 +187,53 @@ pub unsafe extern "C" fn engine_add_resource(
     engine.add_resource(resource).is_ok()
 }
 
+fn resources_from_json(resources: *const c_char) -> Vec<Resource> {
+    let resources = unsafe { CStr::from_ptr(resources) }.to_str().unwrap();
+    serde_json::from_str(resources).unwrap_or_else(|e| {
+        eprintln!("Failed to parse JSON adblock resources: {}", e);
+        vec![]
+    })
+}
+
 /// Adds a list of `Resource`s from JSON format
 #[no_mangle]
 pub unsafe extern "C" fn engine_add_resources(engine: *mut Engine, resources: *const c_char) {
-    let resources = CStr::from_ptr(resources).to_str().unwrap();
-    let resources: Vec<Resource> = serde_json::from_str(resources).unwrap_or_else(|e| {
-        eprintln!("Failed to parse JSON adblock resources: {}", e);
-        vec![]
-    });
+    let resources = resources_from_json(resources);
     assert!(!engine.is_null());
     let engine = Box::leak(Box::from_raw(engine));
     engine.use_resources(&resources);
 }
 
+/// A list of `Resource`s parsed once so that it can be used by any number of
+/// engines.
+pub struct Resources {
+    resources: Vec<Resource>,
+}
+
+/// Parses a list of `Resource`s from JSON format
+#[no_mangle]
+pub unsafe extern "C" fn resources_create(resources: *const c_char) -> *mut Resources {
+    let resources = Resources { resources: resources_from_json(resources) };
+    Box::into_raw(Box::new(resources))
+}
+
+/// Uses previously parsed `Resources` in the engine
+#[no_mangle]
+pub unsafe extern "C" fn engine_use_resources(engine: *mut Engine, resources: *const Resources) {
+    assert!(!engine.is_null());
+    assert!(!resources.is_null());
+    let engine = Box::leak(Box::from_raw(engine));
+    engine.use_resources(&(*resources).resources);
+}
+
+/// Destroy `Resources` once you are done with them.
+#[no_mangle]
+pub unsafe extern "C" fn resources_destroy(resources: *mut Resources) {
+    if !resources.is_null() {
+        drop(Box::from_raw(resources));
+    }
+}
+
 /// Removes a tag to the engine for consideration
 #[no_mangle]
 pub unsafe extern "C" fn engine_remove_tag(engine: *mut Engine, tag: *const c_char) {
@@ -40,6 +40,13 @@ FilterList::FilterList(const FilterList& other) = default;
 
 FilterList::~FilterList() {}
 
+Resources::Resources(const std::string& resources)
+    : raw(resources_create(resources.c_str())) {}
+
+Resources::~Resources() {
+  resources_destroy(raw);
+}
+
 Engine::Engine() : raw(engine_create("")) {}
 
 Engine::Engine(const std::string& rules) : raw(engine_create(rules.c_str())) {}
@@ -108,6 +115,10 @@ void Engine::addResources(const std::string& resources) {
   engine_add_resources(raw, resources.c_str());
 }
 
+void Engine::useResources(const Resources& resources) {
+  engine_use_resources(raw, resources.raw);
+}
+
 const std::string Engine::urlCosmeticResources(const std::string& url) {
   char* resources_raw = engine_url_cosmetic_resources(raw, url.c_str());
   const std::string resources_json = std::string(resources_raw);
@@ -64,6 +64,20 @@ class ADBLOCK_EXPORT FilterList {
   static std::vector<FilterList> regional_list;
 };
 
+// Scriptlet and redirect resources, parsed once so that they can be used by
+// any number of engines.
+class ADBLOCK_EXPORT Resources {
+ public:
+  explicit Resources(const std::string& resources);
+  ~Resources();
+
+ private:
+  friend class Engine;
+  Resources(const Resources&) = delete;
+  void operator=(const Resources&) = delete;
+  C_Resources* raw;
+};
+
 class ADBLOCK_EXPORT Engine {
  public:
   Engine();
@@ -89,6 +103,7 @@ class ADBLOCK_EXPORT Engine {
                    const std::string& content_type,
                    const std::string& data);
   void addResources(const std::string& resources);
+  void useResources(const Resources& resources);
   void removeTag(const std::string& tag);
   bool tagExists(const std::string& tag);
   const std::string urlCosmeticResources(const std::string& url);
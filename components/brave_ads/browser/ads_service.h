@@ -63,6 +63,8 @@ using GetAccountStatementCallback = base::OnceCallback<void(const bool,
 using GetAdDiagnosticsCallback =
     base::OnceCallback<void(const bool, const std::string&)>;
 
+using ShouldLoadHtmlCallback = base::OnceCallback<void(const bool)>;
+
 class AdsService : public KeyedService {
  public:
   AdsService();
@@ -105,10 +107,19 @@ class AdsService : public KeyedService {
 
   virtual void ChangeLocale(const std::string& locale) = 0;
 
+  // Runs |callback| with true if OnHtmlLoaded needs the page HTML for
+  // |redirect_chain|, otherwise OnHtmlLoaded should be passed an empty string.
+  virtual void ShouldLoadHtml(const std::vector<GURL>& redirect_chain,
+                              ShouldLoadHtmlCallback callback) = 0;
+
   virtual void OnHtmlLoaded(const SessionID& tab_id,
                             const std::vector<GURL>& redirect_chain,
                             const std::string& html) = 0;
 
+  // Called when a page was not serialized because ShouldLoadHtml returned
+  // false. |html_size| is the size of the document, if known.
+  virtual void OnHtmlSerializationSkipped(const int64_t html_size) = 0;
+
   virtual void OnTextLoaded(const SessionID& tab_id,
                             const std::vector<GURL>& redirect_chain,
                             const std::string& text) = 0;
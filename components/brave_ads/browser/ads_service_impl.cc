@@ -24,6 +24,7 @@
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/field_trial_params.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/numerics/ranges.h"
 #include "base/path_service.h"
 #include "base/sequenced_task_runner.h"
@@ -306,6 +307,24 @@ void AdsServiceImpl::OnPrefChanged(const std::string& path) {
   bat_ads_->OnPrefChanged(path);
 }
 
+void AdsServiceImpl::ShouldLoadHtml(const std::vector<GURL>& redirect_chain,
+                                    ShouldLoadHtmlCallback callback) {
+  if (!connected()) {
+    std::move(callback).Run(/* should_load */ false);
+    return;
+  }
+
+  std::vector<std::string> redirect_chain_as_strings;
+  for (const auto& url : redirect_chain) {
+    redirect_chain_as_strings.push_back(url.spec());
+  }
+
+  bat_ads_->ShouldLoadHtml(
+      redirect_chain_as_strings,
+      base::BindOnce(&AdsServiceImpl::OnShouldLoadHtml, AsWeakPtr(),
+                     std::move(callback)));
+}
+
 void AdsServiceImpl::OnHtmlLoaded(const SessionID& tab_id,
                                   const std::vector<GURL>& redirect_chain,
                                   const std::string& html) {
@@ -321,6 +340,11 @@ void AdsServiceImpl::OnHtmlLoaded(const SessionID& tab_id,
   bat_ads_->OnHtmlLoaded(tab_id.id(), redirect_chain_as_strings, html);
 }
 
+void AdsServiceImpl::OnHtmlSerializationSkipped(const int64_t html_size) {
+  html_serializations_skipped_++;
+  html_bytes_skipped_ += html_size;
+}
+
 void AdsServiceImpl::OnTextLoaded(const SessionID& tab_id,
                                   const std::vector<GURL>& redirect_chain,
                                   const std::string& text) {
@@ -568,6 +592,8 @@ std::string AdsServiceImpl::GetAutoDetectedAdsSubdivisionTargetingCode() const {
 void AdsServiceImpl::Shutdown() {
   is_initialized_ = false;
 
+  RecordHtmlSerializationSkipped();
+
   BackgroundHelper::GetInstance()->RemoveObserver(this);
 
   g_brave_browser_process->resource_component()->RemoveObserver(this);
@@ -1391,6 +1417,28 @@ void AdsServiceImpl::OnGetAdDiagnostics(GetAdDiagnosticsCallback callback,
   std::move(callback).Run(success, json);
 }
 
+void AdsServiceImpl::OnShouldLoadHtml(ShouldLoadHtmlCallback callback,
+                                      const bool should_load) {
+  std::move(callback).Run(should_load);
+}
+
+void AdsServiceImpl::RecordHtmlSerializationSkipped() {
+  if (html_serializations_skipped_ == 0) {
+    return;
+  }
+
+  VLOG(1) << "Skipped serializing " << html_serializations_skipped_
+          << " pages (" << html_bytes_skipped_ << " bytes) for conversions";
+
+  UMA_HISTOGRAM_COUNTS_10000("Brave.Ads.HtmlSerializationsSkipped",
+                             html_serializations_skipped_);
+  UMA_HISTOGRAM_MEMORY_KB("Brave.Ads.HtmlSerializationKBSkipped",
+                          static_cast<int>(html_bytes_skipped_ / 1024));
+
+  html_serializations_skipped_ = 0;
+  html_bytes_skipped_ = 0;
+}
+
 void AdsServiceImpl::OnRemoveAllHistory(const bool success) {
   if (!success) {
     VLOG(0) << "Failed to remove ads history";
@@ -127,10 +127,15 @@ class AdsServiceImpl : public AdsService,
 
   void OnPrefChanged(const std::string& path);
 
+  void ShouldLoadHtml(const std::vector<GURL>& redirect_chain,
+                      ShouldLoadHtmlCallback callback) override;
+
   void OnHtmlLoaded(const SessionID& tab_id,
                     const std::vector<GURL>& redirect_chain,
                     const std::string& html) override;
 
+  void OnHtmlSerializationSkipped(const int64_t html_size) override;
+
   void OnTextLoaded(const SessionID& tab_id,
                     const std::vector<GURL>& redirect_chain,
                     const std::string& text) override;
@@ -294,6 +299,11 @@ class AdsServiceImpl : public AdsService,
 
   void OnRemoveAllHistory(const bool success);
 
+  void OnShouldLoadHtml(ShouldLoadHtmlCallback callback,
+                        const bool should_load);
+
+  void RecordHtmlSerializationSkipped();
+
   void OnToggleAdThumbUp(OnToggleAdThumbUpCallback callback,
                          const std::string& creative_instance_id,
                          const int action);
@@ -501,6 +511,10 @@ class AdsServiceImpl : public AdsService,
 
   base::RepeatingTimer idle_poll_timer_;
 
+  // Pages and bytes not serialized for OnHtmlLoaded since the service started.
+  int html_serializations_skipped_ = 0;
+  int64_t html_bytes_skipped_ = 0;
+
   PrefChangeRegistrar profile_pref_change_registrar_;
 
   SimpleURLLoaderList url_loaders_;
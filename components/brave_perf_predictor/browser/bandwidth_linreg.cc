@@ -11,12 +11,44 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_features.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 
 namespace brave_perf_predictor {
 
 namespace {
 
+constexpr size_t kEntitySlotCount = size_t{1} << relevant_entity_hash_bits;
+constexpr uint8_t kNoEntity = 0xff;
+static_assert(relevant_entities.size() < kNoEntity,
+              "Entity slots hold an uint8_t index into relevant_entities");
+
+struct EntitySlots {
+  uint8_t entity[kEntitySlotCount];
+  bool collision_free;
+};
+
+constexpr EntitySlots BuildEntitySlots() {
+  EntitySlots slots = {};
+  for (size_t i = 0; i < kEntitySlotCount; i++)
+    slots.entity[i] = kNoEntity;
+  slots.collision_free = true;
+  for (size_t i = 0; i < relevant_entities.size(); i++) {
+    const uint32_t slot =
+        internal::HashEntity(relevant_entities[i],
+                             internal::StringLength(relevant_entities[i]));
+    if (slots.entity[slot] != kNoEntity)
+      slots.collision_free = false;
+    slots.entity[slot] = static_cast<uint8_t>(i);
+  }
+  return slots;
+}
+
+constexpr EntitySlots kEntitySlots = BuildEntitySlots();
+static_assert(kEntitySlots.collision_free,
+              "relevant_entity_hash_seed is not a perfect hash for "
+              "relevant_entities, re-export the model");
+
 bool StandardiseFeatsNoOutliers(
     std::array<double, standardise_feat_count>* features,
     const std::array<double, standardise_feat_count>& means,
@@ -75,4 +107,12 @@ double LinregPredictNamed(const base::flat_map<std::string, double>& features) {
   return LinregPredictVector(feature_vector);
 }
 
+absl::optional<size_t> GetThirdPartyBlockedFeature(base::StringPiece entity) {
+  const uint8_t index =
+      kEntitySlots.entity[internal::HashEntity(entity.data(), entity.size())];
+  if (index == kNoEntity || entity != relevant_entities[index])
+    return absl::nullopt;
+  return kThirdPartyBlockedFeatures + index;
+}
+
 }  // namespace brave_perf_predictor
@@ -10,7 +10,9 @@
 #include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace brave_perf_predictor {
 
@@ -31,6 +33,12 @@ double LinregPredictVector(const std::array<double, feature_count>& features);
 // any extra features.
 double LinregPredictNamed(const base::flat_map<std::string, double>& features);
 
+// Returns the position of the "thirdParties.<entity>.blocked" feature in the
+// feature vector, or nullopt if |entity| is not one the model knows about.
+// Uses a perfect hash over |relevant_entities|, so it costs one hash and one
+// string comparison.
+absl::optional<size_t> GetThirdPartyBlockedFeature(base::StringPiece entity);
+
 }  // namespace brave_perf_predictor
 
 #endif  // BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_H_
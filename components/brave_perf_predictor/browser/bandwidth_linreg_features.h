@@ -0,0 +1,170 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_FEATURES_H_
+#define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_FEATURES_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <initializer_list>
+
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
+
+// Compile-time index into the feature vector expected by the model in
+// bandwidth_linreg_parameters.h. Every index is resolved by name against
+// |feature_sequence|, so a regenerated model with a different feature order
+// keeps working and a model missing a feature fails to compile.
+
+namespace brave_perf_predictor {
+
+namespace internal {
+
+constexpr size_t StringLength(const char* str) {
+  size_t length = 0;
+  while (str[length] != '\0')
+    length++;
+  return length;
+}
+
+constexpr bool StringEquals(const char* a, const char* b) {
+  size_t i = 0;
+  for (; a[i] != '\0' && b[i] != '\0'; i++) {
+    if (a[i] != b[i])
+      return false;
+  }
+  return a[i] == b[i];
+}
+
+// Returns true if |str| is exactly |prefix| + |middle| + |suffix|.
+constexpr bool StringEqualsConcat(const char* str,
+                                  const char* prefix,
+                                  const char* middle,
+                                  const char* suffix) {
+  for (const char* part : {prefix, middle, suffix}) {
+    for (; *part != '\0'; part++, str++) {
+      if (*str != *part)
+        return false;
+    }
+  }
+  return *str == '\0';
+}
+
+constexpr size_t FindFeature(const char* name) {
+  for (size_t i = 0; i < feature_sequence.size(); i++) {
+    if (StringEquals(feature_sequence[i], name))
+      return i;
+  }
+  return feature_sequence.size();
+}
+
+// FNV-1a keeping the top |relevant_entity_hash_bits| bits. The seed is
+// picked by python/model.py so that no two relevant entities share a slot.
+constexpr uint32_t HashEntity(const char* data, size_t length) {
+  uint32_t hash = 2166136261u ^ relevant_entity_hash_seed;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 16777619u;
+  }
+  return hash >> (32 - relevant_entity_hash_bits);
+}
+
+}  // namespace internal
+
+struct ResourceFeatures {
+  size_t request_count;
+  size_t size;
+};
+
+constexpr size_t kAdblockRequests = internal::FindFeature("adblockRequests");
+constexpr size_t kFirstMeaningfulPaint =
+    internal::FindFeature("metrics.firstMeaningfulPaint");
+constexpr size_t kObservedDomContentLoaded =
+    internal::FindFeature("metrics.observedDomContentLoaded");
+constexpr size_t kObservedFirstVisualChange =
+    internal::FindFeature("metrics.observedFirstVisualChange");
+constexpr size_t kObservedLoad = internal::FindFeature("metrics.observedLoad");
+
+constexpr ResourceFeatures kDocumentResources = {
+    internal::FindFeature("resources.document.requestCount"),
+    internal::FindFeature("resources.document.size")};
+constexpr ResourceFeatures kFontResources = {
+    internal::FindFeature("resources.font.requestCount"),
+    internal::FindFeature("resources.font.size")};
+constexpr ResourceFeatures kImageResources = {
+    internal::FindFeature("resources.image.requestCount"),
+    internal::FindFeature("resources.image.size")};
+constexpr ResourceFeatures kMediaResources = {
+    internal::FindFeature("resources.media.requestCount"),
+    internal::FindFeature("resources.media.size")};
+constexpr ResourceFeatures kOtherResources = {
+    internal::FindFeature("resources.other.requestCount"),
+    internal::FindFeature("resources.other.size")};
+constexpr ResourceFeatures kScriptResources = {
+    internal::FindFeature("resources.script.requestCount"),
+    internal::FindFeature("resources.script.size")};
+constexpr ResourceFeatures kStylesheetResources = {
+    internal::FindFeature("resources.stylesheet.requestCount"),
+    internal::FindFeature("resources.stylesheet.size")};
+constexpr ResourceFeatures kThirdPartyResources = {
+    internal::FindFeature("resources.third-party.requestCount"),
+    internal::FindFeature("resources.third-party.size")};
+constexpr ResourceFeatures kTotalResources = {
+    internal::FindFeature("resources.total.requestCount"),
+    internal::FindFeature("resources.total.size")};
+
+// "thirdParties.<entity>.blocked" features follow the numeric ones, in the
+// order of |relevant_entities|.
+constexpr size_t kThirdPartyBlockedFeatures =
+    feature_sequence.size() - relevant_entities.size();
+
+namespace internal {
+
+constexpr bool AreFeatures(std::initializer_list<size_t> indices) {
+  for (size_t index : indices) {
+    if (index >= feature_sequence.size())
+      return false;
+  }
+  return true;
+}
+
+constexpr bool AreFeatures(std::initializer_list<ResourceFeatures> features) {
+  for (const ResourceFeatures& feature : features) {
+    if (!AreFeatures({feature.request_count, feature.size}))
+      return false;
+  }
+  return true;
+}
+
+constexpr bool ThirdPartyFeaturesMatchEntities() {
+  for (size_t i = 0; i < relevant_entities.size(); i++) {
+    if (!StringEqualsConcat(feature_sequence[kThirdPartyBlockedFeatures + i],
+                            "thirdParties.", relevant_entities[i],
+                            ".blocked")) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace internal
+
+static_assert(internal::AreFeatures({kAdblockRequests, kFirstMeaningfulPaint,
+                                     kObservedDomContentLoaded,
+                                     kObservedFirstVisualChange,
+                                     kObservedLoad}),
+              "Model is missing a blocking or timing feature");
+static_assert(internal::AreFeatures(
+                  {kDocumentResources, kFontResources, kImageResources,
+                   kMediaResources, kOtherResources, kScriptResources,
+                   kStylesheetResources, kThirdPartyResources,
+                   kTotalResources}),
+              "Model is missing a resource feature");
+static_assert(internal::ThirdPartyFeaturesMatchEntities(),
+              "Third party features must match relevant_entities");
+
+}  // namespace brave_perf_predictor
+
+#endif  // BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_FEATURES_H_
@@ -8,6 +8,8 @@
 
 /* This file is automatically generated, do not edit directly */
 
+#include <stdint.h>
+
 #include <string>
 #include <array>
 
@@ -288,7 +290,7 @@ constexpr std::array<double, standardise_feat_count> standardise_feat_scale = {
 3333644.900695055
 };
 
-const std::array<std::string, feature_count> feature_sequence{
+constexpr std::array<const char*, feature_count> feature_sequence{
     "adblockRequests",
     "metrics.firstMeaningfulPaint",
     "metrics.observedDomContentLoaded",
@@ -504,7 +506,7 @@ const std::array<std::string, feature_count> feature_sequence{
     "thirdParties.Yandex APIs.blocked",
 };
 
-const std::array<std::string, 190> relevant_entities{
+constexpr std::array<const char*, 190> relevant_entities{
   "Google Analytics",
   "Facebook",
   "Google CDN",
@@ -697,6 +699,9 @@ const std::array<std::string, 190> relevant_entities{
   "Yandex APIs",
 };
 
+constexpr unsigned int relevant_entity_hash_bits = 11;
+constexpr uint32_t relevant_entity_hash_seed = 12222;
+
 const base::flat_set<std::string> relevant_entity_set(
     relevant_entities.begin(),
     relevant_entities.end());
@@ -5,16 +5,42 @@
 
 #include "brave/components/brave_perf_predictor/browser/bandwidth_savings_predictor.h"
 
-#include <iostream>
-
 #include "base/logging.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg.h"
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_features.h"
 #include "components/page_load_metrics/common/page_load_metrics.mojom.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom.h"
 
 namespace brave_perf_predictor {
 
+namespace {
+
+const ResourceFeatures& GetResourceFeatures(
+    network::mojom::RequestDestination destination) {
+  switch (destination) {
+    case network::mojom::RequestDestination::kDocument:
+    case network::mojom::RequestDestination::kIframe:
+      return kDocumentResources;
+    case network::mojom::RequestDestination::kStyle:
+      return kStylesheetResources;
+    case network::mojom::RequestDestination::kScript:
+      return kScriptResources;
+    case network::mojom::RequestDestination::kImage:
+      return kImageResources;
+    case network::mojom::RequestDestination::kFont:
+      return kFontResources;
+    case network::mojom::RequestDestination::kAudio:
+    case network::mojom::RequestDestination::kTrack:
+    case network::mojom::RequestDestination::kVideo:
+      return kMediaResources;
+    default:
+      return kOtherResources;
+  }
+}
+
+}  // namespace
+
 BandwidthSavingsPredictor::BandwidthSavingsPredictor(
     const NamedThirdPartyRegistry* registry)
     : tp_registry_(registry) {}
@@ -25,34 +51,37 @@ void BandwidthSavingsPredictor::OnPageLoadTimingUpdated(
     const page_load_metrics::mojom::PageLoadTiming& timing) {
   // First meaningful paint
   if (timing.paint_timing->first_meaningful_paint.has_value())
-    feature_map_["metrics.firstMeaningfulPaint"] =
+    features_[kFirstMeaningfulPaint] =
         timing.paint_timing->first_meaningful_paint.value().InMillisecondsF();
 
   // DOM Content Loaded
   if (timing.document_timing->dom_content_loaded_event_start.has_value())
-    feature_map_["metrics.observedDomContentLoaded"] =
+    features_[kObservedDomContentLoaded] =
         timing.document_timing->dom_content_loaded_event_start.value()
             .InMillisecondsF();
 
   // First contentful paint
   if (timing.paint_timing->first_contentful_paint.has_value())
-    feature_map_["metrics.observedFirstVisualChange"] =
+    features_[kObservedFirstVisualChange] =
         timing.paint_timing->first_contentful_paint.value().InMillisecondsF();
 
   // Load
   if (timing.document_timing->load_event_start.has_value())
-    feature_map_["metrics.observedLoad"] =
+    features_[kObservedLoad] =
         timing.document_timing->load_event_start.value().InMillisecondsF();
 }
 
 void BandwidthSavingsPredictor::OnSubresourceBlocked(
     const std::string& resource_url) {
-  feature_map_["adblockRequests"] += 1;
+  features_[kAdblockRequests] += 1;
 
   if (tp_registry_) {
     const auto tp_name = tp_registry_->GetThirdParty(resource_url);
-    if (tp_name.has_value())
-      feature_map_["thirdParties." + tp_name.value() + ".blocked"] = 1;
+    if (tp_name.has_value()) {
+      const auto feature = GetThirdPartyBlockedFeature(tp_name.value());
+      if (feature.has_value())
+        features_[feature.value()] = 1;
+    }
   }
 }
 
@@ -73,47 +102,18 @@ void BandwidthSavingsPredictor::OnResourceLoadComplete(
           net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
 
   if (is_third_party) {
-    feature_map_["resources.third-party.requestCount"] += 1;
-    feature_map_["resources.third-party.size"] +=
-        resource_load_info.raw_body_bytes;
+    features_[kThirdPartyResources.request_count] += 1;
+    features_[kThirdPartyResources.size] += resource_load_info.raw_body_bytes;
   }
 
-  feature_map_["resources.total.requestCount"] += 1;
-  feature_map_["resources.total.size"] += resource_load_info.raw_body_bytes;
-  feature_map_["transfer.total.size"] +=
-      resource_load_info.total_received_bytes;
-  std::string resource_type;
-  switch (resource_load_info.request_destination) {
-    case network::mojom::RequestDestination::kDocument:
-      resource_type = "document";
-      break;
-    case network::mojom::RequestDestination::kIframe:
-      resource_type = "document";
-      break;
-    case network::mojom::RequestDestination::kStyle:
-      resource_type = "stylesheet";
-      break;
-    case network::mojom::RequestDestination::kScript:
-      resource_type = "script";
-      break;
-    case network::mojom::RequestDestination::kImage:
-      resource_type = "image";
-      break;
-    case network::mojom::RequestDestination::kFont:
-      resource_type = "font";
-      break;
-    case network::mojom::RequestDestination::kAudio:
-    case network::mojom::RequestDestination::kTrack:
-    case network::mojom::RequestDestination::kVideo:
-      resource_type = "media";
-      break;
-    default:
-      resource_type = "other";
-      break;
-  }
-  feature_map_["resources." + resource_type + ".requestCount"] += 1;
-  feature_map_["resources." + resource_type + ".size"] +=
-      resource_load_info.raw_body_bytes;
+  features_[kTotalResources.request_count] += 1;
+  features_[kTotalResources.size] += resource_load_info.raw_body_bytes;
+  transfer_total_size_ += resource_load_info.total_received_bytes;
+
+  const ResourceFeatures& resource_type =
+      GetResourceFeatures(resource_load_info.request_destination);
+  features_[resource_type.request_count] += 1;
+  features_[resource_type.size] += resource_load_info.raw_body_bytes;
 }
 
 double BandwidthSavingsPredictor::PredictSavingsBytes() const {
@@ -121,37 +121,37 @@ double BandwidthSavingsPredictor::PredictSavingsBytes() const {
       !main_frame_url_.SchemeIsHTTPOrHTTPS()) {
     return 0;
   }
-  const auto total_size = feature_map_.find("transfer.total.size");
-  if (total_size != feature_map_.end() && total_size->second > 0) {
-    VLOG(2) << main_frame_url_ << " total download size " << total_size->second
-            << " bytes";
+  if (transfer_total_size_ > 0) {
+    VLOG(2) << main_frame_url_ << " total download size "
+            << transfer_total_size_ << " bytes";
   } else {
     return 0;
   }
 
   // Short-circuit if nothing got blocked
-  const auto adblock_requests = feature_map_.find("adblockRequests");
-  if (adblock_requests == feature_map_.end() || adblock_requests->second < 1) {
+  if (features_[kAdblockRequests] < 1) {
     return 0;
   }
   if (VLOG_IS_ON(3)) {
-    VLOG(3) << "Predicting on feature map:";
-    for (const auto& feature : feature_map_) {
-      VLOG(3) << feature.first << " :: " << feature.second;
+    VLOG(3) << "Predicting on features:";
+    for (size_t i = 0; i < features_.size(); i++) {
+      if (features_[i] != 0)
+        VLOG(3) << feature_sequence[i] << " :: " << features_[i];
     }
   }
-  double prediction = ::brave_perf_predictor::LinregPredictNamed(feature_map_);
+  double prediction = ::brave_perf_predictor::LinregPredictVector(features_);
   VLOG(2) << main_frame_url_ << " estimated saving " << prediction << " bytes";
   // Sanity check for predicted saving
   if (prediction > kSavingsAbsoluteOutlier &&
-      (prediction / kOutlierThreshold) > total_size->second) {
+      (prediction / kOutlierThreshold) > transfer_total_size_) {
     return 0;
   }
   return prediction;
 }
 
 void BandwidthSavingsPredictor::Reset() {
-  feature_map_.clear();
+  features_.fill(0);
+  transfer_total_size_ = 0;
   main_frame_url_ = {};
 }
 
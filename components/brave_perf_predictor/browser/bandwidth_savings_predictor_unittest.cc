@@ -6,20 +6,130 @@
 #include "brave/components/brave_perf_predictor/browser/bandwidth_savings_predictor.h"
 
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/cxx17_backports.h"
 #include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/test/task_environment.h"
 #include "base/time/time.h"
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg.h"
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_features.h"
 #include "chrome/browser/predictors/loading_test_util.h"
 #include "components/page_load_metrics/common/page_load_metrics.mojom.h"
 #include "components/page_load_metrics/common/page_load_timing.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom.h"
 #include "url/gurl.h"
 
 namespace brave_perf_predictor {
 
+namespace {
+
+constexpr size_t kPageResources = 500;
+
+struct TestPage {
+  GURL main_frame;
+  std::vector<std::string> blocked;
+  std::vector<blink::mojom::ResourceLoadInfoPtr> resources;
+};
+
+// A page of |kPageResources| resources spread over first and third parties,
+// with every fifth request blocked.
+TestPage CreateTestPage() {
+  const char* kOrigins[] = {"https://brave.com",
+                            "https://cdn.brave.com",
+                            "https://google-analytics.com",
+                            "https://connect.facebook.net",
+                            "https://stackpath.bootstrapcdn.com",
+                            "https://ajax.googleapis.com",
+                            "https://platform.twitter.com"};
+  const network::mojom::RequestDestination kDestinations[] = {
+      network::mojom::RequestDestination::kScript,
+      network::mojom::RequestDestination::kStyle,
+      network::mojom::RequestDestination::kImage,
+      network::mojom::RequestDestination::kFont,
+      network::mojom::RequestDestination::kVideo,
+      network::mojom::RequestDestination::kIframe,
+      network::mojom::RequestDestination::kEmpty};
+
+  TestPage page;
+  page.main_frame = GURL("https://brave.com/");
+  for (size_t i = 0; i < kPageResources; i++) {
+    const std::string url = std::string(kOrigins[i % base::size(kOrigins)]) +
+                            "/resource" + base::NumberToString(i);
+    auto resource = predictors::CreateResourceLoadInfo(
+        url, kDestinations[i % base::size(kDestinations)]);
+    if (i % 5 == 0) {
+      page.blocked.push_back(url);
+      resource->raw_body_bytes = 0;
+      resource->total_received_bytes = 0;
+    } else {
+      resource->raw_body_bytes = 1000 + i;
+      resource->total_received_bytes = 1200 + i;
+    }
+    page.resources.push_back(std::move(resource));
+  }
+  return page;
+}
+
+// String keyed featurisation, as the predictor did before feature indices
+// were resolved at compile time. Used as the reference implementation.
+void FeaturiseNamed(const NamedThirdPartyRegistry& registry,
+                    const TestPage& page,
+                    base::flat_map<std::string, double>* features) {
+  for (const std::string& url : page.blocked) {
+    (*features)["adblockRequests"] += 1;
+    const auto tp_name = registry.GetThirdParty(url);
+    if (tp_name.has_value())
+      (*features)["thirdParties." + tp_name.value() + ".blocked"] = 1;
+  }
+  for (const auto& resource : page.resources) {
+    if (!net::registry_controlled_domains::SameDomainOrHost(
+            page.main_frame, resource->final_url,
+            net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES)) {
+      (*features)["resources.third-party.requestCount"] += 1;
+      (*features)["resources.third-party.size"] += resource->raw_body_bytes;
+    }
+    (*features)["resources.total.requestCount"] += 1;
+    (*features)["resources.total.size"] += resource->raw_body_bytes;
+    (*features)["transfer.total.size"] += resource->total_received_bytes;
+    std::string resource_type;
+    switch (resource->request_destination) {
+      case network::mojom::RequestDestination::kIframe:
+        resource_type = "document";
+        break;
+      case network::mojom::RequestDestination::kStyle:
+        resource_type = "stylesheet";
+        break;
+      case network::mojom::RequestDestination::kScript:
+        resource_type = "script";
+        break;
+      case network::mojom::RequestDestination::kImage:
+        resource_type = "image";
+        break;
+      case network::mojom::RequestDestination::kFont:
+        resource_type = "font";
+        break;
+      case network::mojom::RequestDestination::kVideo:
+        resource_type = "media";
+        break;
+      default:
+        resource_type = "other";
+        break;
+    }
+    (*features)["resources." + resource_type + ".requestCount"] += 1;
+    (*features)["resources." + resource_type + ".size"] +=
+        resource->raw_body_bytes;
+  }
+}
+
+}  // namespace
+
 class BandwidthSavingsPredictorTest : public ::testing::Test {
  public:
   BandwidthSavingsPredictorTest() {
@@ -39,45 +149,46 @@ class BandwidthSavingsPredictorTest : public ::testing::Test {
 
 TEST_F(BandwidthSavingsPredictorTest, FeaturiseBlocked) {
   predictor_->OnSubresourceBlocked("https://google-analytics.com");
-  EXPECT_EQ(predictor_->feature_map_["adblockRequests"], 1);
-  EXPECT_EQ(predictor_->feature_map_["thirdParties.Google Analytics.blocked"],
-            1);
+  EXPECT_EQ(predictor_->features_[kAdblockRequests], 1);
+  EXPECT_EQ(
+      predictor_->features_[*GetThirdPartyBlockedFeature("Google Analytics")],
+      1);
   predictor_->OnSubresourceBlocked("https://test.m.facebook.com");
-  EXPECT_EQ(predictor_->feature_map_["adblockRequests"], 2);
+  EXPECT_EQ(predictor_->features_[kAdblockRequests], 2);
 }
 
 TEST_F(BandwidthSavingsPredictorTest, FeaturiseTiming) {
   const auto empty_timing = page_load_metrics::CreatePageLoadTiming();
   predictor_->OnPageLoadTimingUpdated(*empty_timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.firstMeaningfulPaint"], 0);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedDomContentLoaded"], 0);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedFirstVisualChange"], 0);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedLoad"], 0);
+  EXPECT_EQ(predictor_->features_[kFirstMeaningfulPaint], 0);
+  EXPECT_EQ(predictor_->features_[kObservedDomContentLoaded], 0);
+  EXPECT_EQ(predictor_->features_[kObservedFirstVisualChange], 0);
+  EXPECT_EQ(predictor_->features_[kObservedLoad], 0);
 
   auto timing = page_load_metrics::CreatePageLoadTiming();
   timing->document_timing->dom_content_loaded_event_start =
       base::TimeDelta::FromMilliseconds(1000);
   predictor_->OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedDomContentLoaded"], 1000);
+  EXPECT_EQ(predictor_->features_[kObservedDomContentLoaded], 1000);
 
   timing->document_timing->load_event_start =
       base::TimeDelta::FromMilliseconds(2000);
   predictor_->OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedLoad"], 2000);
+  EXPECT_EQ(predictor_->features_[kObservedLoad], 2000);
 
   timing->paint_timing->first_meaningful_paint =
       base::TimeDelta::FromMilliseconds(1500);
   predictor_->OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.firstMeaningfulPaint"], 1500);
+  EXPECT_EQ(predictor_->features_[kFirstMeaningfulPaint], 1500);
 
   timing->paint_timing->first_contentful_paint =
       base::TimeDelta::FromMilliseconds(800);
   predictor_->OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedFirstVisualChange"], 800);
+  EXPECT_EQ(predictor_->features_[kObservedFirstVisualChange], 800);
 }
 
 TEST_F(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
-  EXPECT_EQ(predictor_->feature_map_["resources.third-party.requestCount"], 0);
+  EXPECT_EQ(predictor_->features_[kThirdPartyResources.request_count], 0);
 
   const GURL main_frame("https://brave.com/");
 
@@ -86,9 +197,9 @@ TEST_F(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
       network::mojom::RequestDestination::kStyle);
   fp_style->raw_body_bytes = 1000;
   predictor_->OnResourceLoadComplete(main_frame, *fp_style);
-  EXPECT_EQ(predictor_->feature_map_["resources.third-party.requestCount"], 0);
-  EXPECT_EQ(predictor_->feature_map_["resources.stylesheet.requestCount"], 1);
-  EXPECT_EQ(predictor_->feature_map_["resources.stylesheet.size"], 1000);
+  EXPECT_EQ(predictor_->features_[kThirdPartyResources.request_count], 0);
+  EXPECT_EQ(predictor_->features_[kStylesheetResources.request_count], 1);
+  EXPECT_EQ(predictor_->features_[kStylesheetResources.size], 1000);
 
   auto tp_style = predictors::CreateResourceLoadInfo(
       "https://stackpath.bootstrapcdn.com/bootstrap/4.4.1/css/bootstrap.min.js",
@@ -96,14 +207,64 @@ TEST_F(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
   tp_style->raw_body_bytes = 1001;
   predictor_->OnResourceLoadComplete(main_frame, *tp_style);
 
-  EXPECT_EQ(predictor_->feature_map_["resources.third-party.requestCount"], 1);
-  EXPECT_EQ(predictor_->feature_map_["resources.stylesheet.requestCount"], 1);
-  EXPECT_EQ(predictor_->feature_map_["resources.script.requestCount"], 1);
-  EXPECT_EQ(predictor_->feature_map_["resources.stylesheet.size"], 1000);
-  EXPECT_EQ(predictor_->feature_map_["resources.script.size"], 1001);
+  EXPECT_EQ(predictor_->features_[kThirdPartyResources.request_count], 1);
+  EXPECT_EQ(predictor_->features_[kStylesheetResources.request_count], 1);
+  EXPECT_EQ(predictor_->features_[kScriptResources.request_count], 1);
+  EXPECT_EQ(predictor_->features_[kStylesheetResources.size], 1000);
+  EXPECT_EQ(predictor_->features_[kScriptResources.size], 1001);
 
-  EXPECT_EQ(predictor_->feature_map_["resources.total.requestCount"], 2);
-  EXPECT_EQ(predictor_->feature_map_["resources.total.size"], 2001);
+  EXPECT_EQ(predictor_->features_[kTotalResources.request_count], 2);
+  EXPECT_EQ(predictor_->features_[kTotalResources.size], 2001);
+}
+
+TEST_F(BandwidthSavingsPredictorTest, FeaturiseMatchesNamedFeatures) {
+  const TestPage page = CreateTestPage();
+  for (const std::string& url : page.blocked)
+    predictor_->OnSubresourceBlocked(url);
+  for (const auto& resource : page.resources)
+    predictor_->OnResourceLoadComplete(page.main_frame, *resource);
+
+  base::flat_map<std::string, double> named_features;
+  FeaturiseNamed(*tp_registry_, page, &named_features);
+
+  for (size_t i = 0; i < predictor_->features_.size(); i++) {
+    const auto it = named_features.find(feature_sequence[i]);
+    EXPECT_EQ(predictor_->features_[i],
+              it == named_features.end() ? 0 : it->second)
+        << feature_sequence[i];
+  }
+  EXPECT_EQ(predictor_->transfer_total_size_,
+            named_features["transfer.total.size"]);
+  EXPECT_DOUBLE_EQ(predictor_->PredictSavingsBytes(),
+                   LinregPredictNamed(named_features));
+}
+
+TEST_F(BandwidthSavingsPredictorTest, ThirdPartyBlockedFeatures) {
+  for (size_t i = 0; i < relevant_entities.size(); i++) {
+    EXPECT_EQ(GetThirdPartyBlockedFeature(relevant_entities[i]),
+              kThirdPartyBlockedFeatures + i);
+  }
+  EXPECT_FALSE(GetThirdPartyBlockedFeature("").has_value());
+  EXPECT_FALSE(GetThirdPartyBlockedFeature("Not An Entity").has_value());
+  EXPECT_FALSE(GetThirdPartyBlockedFeature("google analytics").has_value());
+}
+
+TEST_F(BandwidthSavingsPredictorTest, ResetGivesRepeatablePredictions) {
+  constexpr int kPages = 20;
+  const TestPage page = CreateTestPage();
+
+  base::flat_map<std::string, double> named_features;
+  FeaturiseNamed(*tp_registry_, page, &named_features);
+  const double named_prediction = LinregPredictNamed(named_features);
+
+  for (int i = 0; i < kPages; i++) {
+    predictor_->Reset();
+    for (const std::string& url : page.blocked)
+      predictor_->OnSubresourceBlocked(url);
+    for (const auto& resource : page.resources)
+      predictor_->OnResourceLoadComplete(page.main_frame, *resource);
+    EXPECT_DOUBLE_EQ(predictor_->PredictSavingsBytes(), named_prediction);
+  }
 }
 
 TEST_F(BandwidthSavingsPredictorTest, PredictZeroNoData) {
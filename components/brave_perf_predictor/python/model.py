@@ -148,6 +148,28 @@ def train_model(print_params=False, reg=REGRESSOR):
 
     return model.get_params()
 
+def _entity_hash(entity, seed, bits):
+    """
+    FNV-1a over the UTF-8 entity name, keeping the top |bits| bits.
+    Must match internal::HashEntity in bandwidth_linreg_features.h
+    """
+    value = 2166136261 ^ seed
+    for byte in entity.encode('utf-8'):
+        value = ((value ^ byte) * 16777619) & 0xffffffff
+    return value >> (32 - bits)
+
+
+def _find_entity_hash(entities, bits=11, max_seed=1 << 20):
+    """
+    Find a seed for which every entity gets a slot of its own
+    """
+    for seed in range(max_seed):
+        slots = {_entity_hash(entity, seed, bits) for entity in entities}
+        if len(slots) == len(entities):
+            return {'bits': bits, 'seed': seed}
+    return _find_entity_hash(entities, bits + 1, max_seed)
+
+
 def export_model():
     # Load trained model and predict on test set
     model = joblib.load(MODEL_PATH)
@@ -176,6 +198,7 @@ def export_model():
         else:
             raise Exception('Unexpected pre_processor transformer: {}'.format(name))
 
+    entities = [ feature.replace('thirdParties.', '').replace('.blocked', '') for feature in transformers['passthrough']['features'] if feature.startswith('thirdParties.') ]
     env = jinja2.Environment(loader=jinja2.FileSystemLoader(EXPORT_TEMPLATE_PATH), trim_blocks=True, lstrip_blocks=True)
     data = {
         'transformers': transformers,
@@ -184,7 +207,8 @@ def export_model():
             'coefficients': model['model'].coef_
         },
         'misc': {
-            'entities': [ feature.replace('thirdParties.', '').replace('.blocked', '') for feature in transformers['passthrough']['features'] if feature.startswith('thirdParties.') ]
+            'entities': entities,
+            'entity_hash': _find_entity_hash(entities)
         }
     }
     env.get_template(EXPORT_TEMPLATE_NAME).stream(data).dump(EXPORT_OUTPUT_PATH)
@@ -8,6 +8,8 @@
 
 /* This file is automatically generated, do not edit directly */
 
+#include <stdint.h>
+
 #include <string>
 #include <array>
 
@@ -32,7 +34,7 @@ constexpr std::array<double, standardise_feat_count> standardise_feat_scale = {
 {{transformers.standardise.scale | join(',\n')}}
 };
 
-const std::array<std::string, feature_count> feature_sequence{
+constexpr std::array<const char*, feature_count> feature_sequence{
     {% for feature in transformers.standardise.features %}
     "{{feature}}",
     {% endfor %}
@@ -41,12 +43,15 @@ const std::array<std::string, feature_count> feature_sequence{
     {% endfor %}
 };
 
-const std::array<std::string, {{misc.entities | length}}> relevant_entities{
+constexpr std::array<const char*, {{misc.entities | length}}> relevant_entities{
   {% for entity in misc.entities %}
   "{{entity}}",
   {% endfor %}
 };
 
+constexpr unsigned int relevant_entity_hash_bits = {{misc.entity_hash.bits}};
+constexpr uint32_t relevant_entity_hash_seed = {{misc.entity_hash.seed}};
+
 const base::flat_set<std::string> relevant_entity_set(
     relevant_entities.begin(),
     relevant_entities.end());
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "base/task/post_task.h"
 #include "brave/components/brave_rewards/browser/rewards_service.h"
@@ -55,8 +56,9 @@ int OnBeforeURLRequest(
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
   if (IsMediaLink(ctx->request_url, ctx->tab_origin, ctx->referrer)) {
-    if (!ctx->upload_data.empty()) {
-      DispatchOnUI(ctx->upload_data, ctx->request_url, ctx->tab_url,
+    std::string upload_data = ctx->GetUploadData();
+    if (!upload_data.empty()) {
+      DispatchOnUI(std::move(upload_data), ctx->request_url, ctx->tab_url,
                    ctx->referrer.spec(), ctx->frame_tree_node_id);
     }
   }
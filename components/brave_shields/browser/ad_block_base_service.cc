@@ -21,6 +21,7 @@
 #include "base/task/thread_pool.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_resource_store.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
@@ -191,16 +192,19 @@ void AdBlockBaseService::EnableTag(const std::string& tag, bool enabled) {
   }
 }
 
-void AdBlockBaseService::AddResources(const std::string& resources) {
+void AdBlockBaseService::AddResources(
+    scoped_refptr<AdBlockResourceStore> resource_store) {
+  DCHECK(resource_store);
   if (BrowserThread::CurrentlyOn(BrowserThread::UI)) {
     GetTaskRunner()->PostTask(
-        FROM_HERE, base::BindOnce(&AdBlockBaseService::AddResources,
-                                  base::Unretained(this), resources));
+        FROM_HERE,
+        base::BindOnce(&AdBlockBaseService::AddResources,
+                       base::Unretained(this), std::move(resource_store)));
     return;
   }
 
-  ad_block_client_->addResources(resources);
-  resources_ = resources;
+  resource_store_ = std::move(resource_store);
+  AddKnownResourcesToAdBlockInstance();
 }
 
 bool AdBlockBaseService::TagExists(const std::string& tag) {
@@ -274,7 +278,8 @@ void AdBlockBaseService::AddKnownTagsToAdBlockInstance() {
 }
 
 void AdBlockBaseService::AddKnownResourcesToAdBlockInstance() {
-  ad_block_client_->addResources(resources_);
+  if (resource_store_)
+    ad_block_client_->useResources(resource_store_->resources());
 }
 
 bool AdBlockBaseService::Init() {
@@ -290,7 +295,7 @@ void AdBlockBaseService::ResetForTest(const std::string& rules,
   ad_block_client_.reset(new adblock::Engine(rules));
   AddKnownTagsToAdBlockInstance();
   if (!resources.empty()) {
-    resources_ = resources;
+    resource_store_ = base::MakeRefCounted<AdBlockResourceStore>(resources);
   }
   AddKnownResourcesToAdBlockInstance();
 }
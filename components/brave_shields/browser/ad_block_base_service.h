@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
 #include "base/values.h"
@@ -33,6 +34,8 @@ class Engine;
 
 namespace brave_shields {
 
+class AdBlockResourceStore;
+
 // The base class of the brave shields service in charge of ad-block
 // checking and init.
 class AdBlockBaseService : public BaseBraveShieldsService {
@@ -55,7 +58,7 @@ class AdBlockBaseService : public BaseBraveShieldsService {
       const GURL& url,
       blink::mojom::ResourceType resource_type,
       const std::string& tab_host);
-  void AddResources(const std::string& resources);
+  void AddResources(scoped_refptr<AdBlockResourceStore> resource_store);
   void EnableTag(const std::string& tag, bool enabled);
   bool TagExists(const std::string& tag);
 
@@ -89,7 +92,7 @@ class AdBlockBaseService : public BaseBraveShieldsService {
   void OnPreferenceChanges(const std::string& pref_name);
 
   std::set<std::string> tags_;
-  std::string resources_;
+  scoped_refptr<AdBlockResourceStore> resource_store_;
   base::WeakPtrFactory<AdBlockBaseService> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(AdBlockBaseService);
 };
@@ -33,11 +33,8 @@ std::string AdBlockRegionalService::                            // NOLINT
 
 AdBlockRegionalService::AdBlockRegionalService(
     const adblock::FilterList& catalog_entry,
-    brave_component_updater::BraveComponent::Delegate* delegate,
-    AdBlockRegionalService::ResourcesFileReadyCallback
-        resoures_file_ready_callback)
+    brave_component_updater::BraveComponent::Delegate* delegate)
     : AdBlockBaseService(delegate),
-      resoures_file_ready_callback_(resoures_file_ready_callback),
       uuid_(catalog_entry.uuid),
       title_(catalog_entry.title),
       component_id_(catalog_entry.component_id),
@@ -72,21 +69,9 @@ void AdBlockRegionalService::OnComponentReady(const std::string& component_id,
   base::FilePath dat_file_path =
       install_dir.AppendASCII(std::string("rs-") + uuid_)
           .AddExtension(FILE_PATH_LITERAL(".dat"));
+  // Resources come from the default list's component, loaded once by
+  // AdBlockService and handed down through the regional service manager.
   GetDATFileData(dat_file_path);
-  base::FilePath resources_file_path =
-      install_dir.AppendASCII(kAdBlockResourcesFilename);
-
-  base::PostTaskAndReplyWithResult(
-      GetTaskRunner().get(), FROM_HERE,
-      base::BindOnce(&brave_component_updater::GetDATFileAsString,
-                     resources_file_path),
-      base::BindOnce(&AdBlockRegionalService::OnResourcesFileDataReady,
-                     weak_factory_.GetWeakPtr()));
-}
-
-void AdBlockRegionalService::OnResourcesFileDataReady(
-    const std::string& resources) {
-  resoures_file_ready_callback_.Run(resources);
 }
 
 // static
@@ -102,11 +87,8 @@ void AdBlockRegionalService::SetComponentIdAndBase64PublicKeyForTest(
 
 std::unique_ptr<AdBlockRegionalService> AdBlockRegionalServiceFactory(
     const adblock::FilterList& catalog_entry,
-    brave_component_updater::BraveComponent::Delegate* delegate,
-    AdBlockRegionalService::ResourcesFileReadyCallback
-        resoures_file_ready_callback) {
-  return std::make_unique<AdBlockRegionalService>(catalog_entry, delegate,
-                                                  resoures_file_ready_callback);
+    brave_component_updater::BraveComponent::Delegate* delegate) {
+  return std::make_unique<AdBlockRegionalService>(catalog_entry, delegate);
 }
 
 }  // namespace brave_shields
@@ -12,7 +12,6 @@
 #include <string>
 #include <vector>
 
-#include "base/callback.h"
 #include "base/files/file_path.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
@@ -25,13 +24,9 @@ namespace brave_shields {
 // for a specific region.
 class AdBlockRegionalService : public AdBlockBaseService {
  public:
-  using ResourcesFileReadyCallback =
-      base::RepeatingCallback<void(const std::string&)>;
-
   explicit AdBlockRegionalService(
       const adblock::FilterList& catalog_entry,
-      brave_component_updater::BraveComponent::Delegate* delegate,
-      ResourcesFileReadyCallback resoures_file_ready_callback);
+      brave_component_updater::BraveComponent::Delegate* delegate);
   ~AdBlockRegionalService() override;
 
   void SetCatalogEntry(const adblock::FilterList& entry);
@@ -44,7 +39,6 @@ class AdBlockRegionalService : public AdBlockBaseService {
   void OnComponentReady(const std::string& component_id,
                         const base::FilePath& install_dir,
                         const std::string& manifest) override;
-  void OnResourcesFileDataReady(const std::string& resources);
 
  private:
   friend class ::AdBlockServiceTest;
@@ -55,23 +49,18 @@ class AdBlockRegionalService : public AdBlockBaseService {
       const std::string& component_id,
       const std::string& component_base64_public_key);
 
-  ResourcesFileReadyCallback resoures_file_ready_callback_;
-
   std::string uuid_;
   std::string title_;
   std::string component_id_;
   std::string base64_public_key_;
 
-  base::WeakPtrFactory<AdBlockRegionalService> weak_factory_{this};
   DISALLOW_COPY_AND_ASSIGN(AdBlockRegionalService);
 };
 
 // Creates the AdBlockRegionalService
 std::unique_ptr<AdBlockRegionalService> AdBlockRegionalServiceFactory(
     const adblock::FilterList& catalog_entry,
-    brave_component_updater::BraveComponent::Delegate* delegate,
-    AdBlockRegionalService::ResourcesFileReadyCallback
-        resoures_file_ready_callback);
+    brave_component_updater::BraveComponent::Delegate* delegate);
 
 }  // namespace brave_shields
 
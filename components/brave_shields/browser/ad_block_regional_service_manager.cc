@@ -14,6 +14,7 @@
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service.h"
+#include "brave/components/brave_shields/browser/ad_block_resource_store.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/common/pref_names.h"
@@ -74,11 +75,11 @@ void AdBlockRegionalServiceManager::StartRegionalServices() {
       auto catalog_entry = brave_shields::FindAdBlockFilterListByUUID(
           regional_catalog_, uuid);
       if (catalog_entry != regional_catalog_.end()) {
-        auto regional_service = AdBlockRegionalServiceFactory(
-            *catalog_entry, delegate_,
-            base::BindRepeating(&AdBlockRegionalServiceManager::AddResources,
-                                base::Unretained(this)));
+        auto regional_service =
+            AdBlockRegionalServiceFactory(*catalog_entry, delegate_);
         regional_service->Start();
+        if (resource_store_)
+          regional_service->AddResources(resource_store_);
         regional_services_.insert(
             std::make_pair(uuid, std::move(regional_service)));
       }
@@ -163,11 +164,12 @@ void AdBlockRegionalServiceManager::EnableTag(const std::string& tag,
 }
 
 void AdBlockRegionalServiceManager::AddResources(
-    const std::string& resources) {
+    scoped_refptr<AdBlockResourceStore> resource_store) {
   base::AutoLock lock(regional_services_lock_);
   for (const auto& regional_service : regional_services_) {
-    regional_service.second->AddResources(resources);
+    regional_service.second->AddResources(resource_store);
   }
+  resource_store_ = std::move(resource_store);
 }
 
 void AdBlockRegionalServiceManager::EnableFilterList(
@@ -183,11 +185,11 @@ void AdBlockRegionalServiceManager::EnableFilterList(
     auto it = regional_services_.find(uuid);
     if (enabled) {
       DCHECK(it == regional_services_.end());
-      auto regional_service = AdBlockRegionalServiceFactory(
-          *catalog_entry, delegate_,
-          base::BindRepeating(&AdBlockRegionalServiceManager::AddResources,
-                              base::Unretained(this)));
+      auto regional_service =
+          AdBlockRegionalServiceFactory(*catalog_entry, delegate_);
       regional_service->Start();
+      if (resource_store_)
+        regional_service->AddResources(resource_store_);
       regional_services_.insert(
           std::make_pair(uuid, std::move(regional_service)));
     } else {
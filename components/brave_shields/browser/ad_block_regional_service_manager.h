@@ -32,6 +32,7 @@ using brave_component_updater::BraveComponent;
 namespace brave_shields {
 
 class AdBlockRegionalService;
+class AdBlockResourceStore;
 
 // The AdBlock regional service manager, in charge of initializing and
 // managing regional AdBlock clients.
@@ -60,7 +61,7 @@ class AdBlockRegionalServiceManager {
       blink::mojom::ResourceType resource_type,
       const std::string& tab_host);
   void EnableTag(const std::string& tag, bool enabled);
-  void AddResources(const std::string& resources);
+  void AddResources(scoped_refptr<AdBlockResourceStore> resource_store);
   void EnableFilterList(const std::string& uuid, bool enabled);
 
   absl::optional<base::Value> UrlCosmeticResources(const std::string& url);
@@ -79,6 +80,7 @@ class AdBlockRegionalServiceManager {
   base::Lock regional_services_lock_;
   std::map<std::string, std::unique_ptr<AdBlockRegionalService>>
       regional_services_;
+  scoped_refptr<AdBlockResourceStore> resource_store_;
 
   std::vector<adblock::FilterList> regional_catalog_;
 
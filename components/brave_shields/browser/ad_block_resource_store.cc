@@ -0,0 +1,25 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_resource_store.h"
+
+#include "base/files/file_path.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+
+namespace brave_shields {
+
+AdBlockResourceStore::AdBlockResourceStore(const std::string& resources)
+    : resources_(std::make_unique<adblock::Resources>(resources)) {}
+
+AdBlockResourceStore::~AdBlockResourceStore() = default;
+
+scoped_refptr<AdBlockResourceStore> LoadAdBlockResourceStore(
+    const base::FilePath& resources_file_path) {
+  return base::MakeRefCounted<AdBlockResourceStore>(
+      brave_component_updater::GetDATFileAsString(resources_file_path));
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,51 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_RESOURCE_STORE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_RESOURCE_STORE_H_
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+
+namespace adblock {
+class Resources;
+}
+
+namespace base {
+class FilePath;
+}
+
+namespace brave_shields {
+
+// Scriptlet and redirect resources, parsed once and shared by every ad-block
+// engine that uses them. The store is immutable, so it can be used from any
+// sequence.
+class AdBlockResourceStore
+    : public base::RefCountedThreadSafe<AdBlockResourceStore> {
+ public:
+  explicit AdBlockResourceStore(const std::string& resources);
+
+  const adblock::Resources& resources() const { return *resources_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<AdBlockResourceStore>;
+  ~AdBlockResourceStore();
+
+  const std::unique_ptr<adblock::Resources> resources_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockResourceStore);
+};
+
+// Reads and parses the resources file at |resources_file_path|. Must be called
+// on a sequence that allows blocking.
+scoped_refptr<AdBlockResourceStore> LoadAdBlockResourceStore(
+    const base::FilePath& resources_file_path);
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_RESOURCE_STORE_H_
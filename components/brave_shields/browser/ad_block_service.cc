@@ -21,6 +21,7 @@
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_service.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
+#include "brave/components/brave_shields/browser/ad_block_resource_store.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
@@ -277,8 +278,7 @@ void AdBlockService::OnComponentReady(const std::string& component_id,
       install_dir.AppendASCII(kAdBlockResourcesFilename);
   base::PostTaskAndReplyWithResult(
       GetTaskRunner().get(), FROM_HERE,
-      base::BindOnce(&brave_component_updater::GetDATFileAsString,
-                     resources_file_path),
+      base::BindOnce(&LoadAdBlockResourceStore, resources_file_path),
       base::BindOnce(&AdBlockService::OnResourcesFileDataReady,
                      weak_factory_.GetWeakPtr()));
   base::PostTaskAndReplyWithResult(
@@ -289,9 +289,12 @@ void AdBlockService::OnComponentReady(const std::string& component_id,
                      weak_factory_.GetWeakPtr()));
 }
 
-void AdBlockService::OnResourcesFileDataReady(const std::string& resources) {
-  AddResources(resources);
-  custom_filters_service()->AddResources(resources);
+void AdBlockService::OnResourcesFileDataReady(
+    scoped_refptr<AdBlockResourceStore> resource_store) {
+  AddResources(resource_store);
+  custom_filters_service()->AddResources(resource_store);
+  regional_service_manager()->AddResources(resource_store);
+  subscription_service_manager()->AddResources(std::move(resource_store));
 }
 
 void AdBlockService::OnRegionalCatalogFileDataReady(
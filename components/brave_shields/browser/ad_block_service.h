@@ -80,7 +80,8 @@ class AdBlockService : public AdBlockBaseService {
   void OnComponentReady(const std::string& component_id,
                         const base::FilePath& install_dir,
                         const std::string& manifest) override;
-  void OnResourcesFileDataReady(const std::string& resources);
+  void OnResourcesFileDataReady(
+      scoped_refptr<AdBlockResourceStore> resource_store);
   void OnRegionalCatalogFileDataReady(const std::string& catalog_json);
 
  private:
@@ -20,6 +20,7 @@
 #include "base/util/values/values_util.h"
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_shields/browser/ad_block_resource_store.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager_observer.h"
@@ -167,6 +168,8 @@ void AdBlockSubscriptionServiceManager::CreateSubscription(
   auto subscription_service = std::make_unique<AdBlockSubscriptionService>(
       info, GetSubscriptionPath(sub_url).Append(kCustomSubscriptionListText),
       delegate_);
+  if (resource_store_)
+    subscription_service->AddResources(resource_store_);
   UpdateSubscriptionPrefs(sub_url, info);
 
   {
@@ -301,6 +304,8 @@ void AdBlockSubscriptionServiceManager::LoadSubscriptionServices() {
           info,
           GetSubscriptionPath(sub_url).Append(kCustomSubscriptionListText),
           delegate_);
+      if (resource_store_)
+        subscription_service->AddResources(resource_store_);
 
       subscription_services_.insert(
           std::make_pair(sub_url, std::move(subscription_service)));
@@ -394,11 +399,12 @@ void AdBlockSubscriptionServiceManager::EnableTag(const std::string& tag,
 }
 
 void AdBlockSubscriptionServiceManager::AddResources(
-    const std::string& resources) {
+    scoped_refptr<AdBlockResourceStore> resource_store) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
   for (const auto& subscription_service : subscription_services_) {
-    subscription_service.second->AddResources(resources);
+    subscription_service.second->AddResources(resource_store);
   }
+  resource_store_ = std::move(resource_store);
 }
 
 absl::optional<base::Value>
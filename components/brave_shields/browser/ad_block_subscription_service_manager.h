@@ -13,6 +13,7 @@
 
 #include "base/files/file_path.h"
 #include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/one_shot_event.h"
 #include "base/synchronization/lock.h"
@@ -67,7 +68,7 @@ class AdBlockSubscriptionServiceManager {
                           bool* did_match_important,
                           std::string* mock_data_url);
   void EnableTag(const std::string& tag, bool enabled);
-  void AddResources(const std::string& resources);
+  void AddResources(scoped_refptr<AdBlockResourceStore> resource_store);
 
   absl::optional<base::Value> UrlCosmeticResources(const std::string& url);
   absl::optional<base::Value> HiddenClassIdSelectors(
@@ -117,6 +118,7 @@ class AdBlockSubscriptionServiceManager {
 
   std::map<GURL, std::unique_ptr<AdBlockSubscriptionService>>
       subscription_services_;
+  scoped_refptr<AdBlockResourceStore> resource_store_;
   std::unique_ptr<component_updater::TimerUpdateScheduler>
       subscription_update_timer_;
 
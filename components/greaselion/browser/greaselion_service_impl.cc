@@ -6,7 +6,9 @@
 #include "brave/components/greaselion/browser/greaselion_service_impl.h"
 
 #include <stddef.h>
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,11 +18,14 @@
 #include "base/callback_helpers.h"
 #include "base/command_line.h"
 #include "base/feature_list.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/json/json_file_value_serializer.h"
 #include "base/one_shot_event.h"
 #include "base/sequenced_task_runner.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/post_task.h"
@@ -33,6 +38,7 @@
 #include "brave/components/version_info//version_info.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "components/version_info/version_info.h"
+#include "crypto/secure_hash.h"
 #include "crypto/sha2.h"
 #include "extensions/browser/computed_hashes.h"
 #include "extensions/browser/extension_registry.h"
@@ -60,28 +66,123 @@ bool ShouldComputeHashesForResource(
   return !components.empty() && components[0] != extensions::kMetadataFolder;
 }
 
-// Wraps a Greaselion rule in a component. The component is stored as
-// an unpacked extension in the user data dir. Returns a valid
-// extension that the caller should take ownership of, or nullptr.
+// Bump when the layout of converted extensions changes, so directories
+// converted by an older version are not reused.
+constexpr char kConvertedExtensionFormat[] = "1";
+constexpr char kConvertedExtensionsDirectory[] = "Converted";
+
+base::FilePath GetConvertedExtensionsDir(const base::FilePath& install_dir) {
+  return install_dir.AppendASCII(kConvertedExtensionsDirectory);
+}
+
+// Greaselion scripts are not signed, but the public key for an extension
+// doubles as its unique identity, and we need one of those, so we add the
+// rule name to a known Brave domain and hash the result to create a
+// public key.
+std::string GetPublicKeyForRule(const std::string& script_name) {
+  char raw[crypto::kSHA256Length] = {0};
+  std::string key;
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(brave_component_updater::kUseGoUpdateDev) &&
+      !base::FeatureList::IsEnabled(
+          brave_component_updater::kUseDevUpdaterUrl)) {
+    crypto::SHA256HashString(UPDATER_DEV_ENDPOINT + script_name,
+                             raw,
+                             crypto::kSHA256Length);
+  } else {
+    crypto::SHA256HashString(UPDATER_PROD_ENDPOINT + script_name,
+                             raw,
+                             crypto::kSHA256Length);
+  }
+  base::Base64Encode(base::StringPiece(raw, crypto::kSHA256Length), &key);
+  return key;
+}
+
+// Values are length-prefixed so adjacent fields can't run into each other.
+void HashValue(const std::string& value, crypto::SecureHash* hash) {
+  const uint64_t size = value.size();
+  hash->Update(&size, sizeof(size));
+  hash->Update(value.data(), value.size());
+}
+
+bool HashFile(const base::FilePath& path, crypto::SecureHash* hash) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return false;
+  HashValue(contents, hash);
+  return true;
+}
+
+// Returns a digest of everything that ends up in the extension converted
+// from |rule|, or an empty string if one of its files could not be read.
 //
 // NOTE: This function does file IO and should not be called on the UI thread.
-// NOTE: The caller takes ownership of the directory at extension->path() on the
-// returned object.
-absl::optional<greaselion::GreaselionServiceImpl::GreaselionConvertedExtension>
-ConvertGreaselionRuleToExtensionOnTaskRunner(
-    const greaselion::GreaselionRule& rule,
-    const base::FilePath& install_dir) {
+std::string ComputeRuleContentHash(const greaselion::GreaselionRule& rule) {
+  std::unique_ptr<crypto::SecureHash> hash =
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+  HashValue(kConvertedExtensionFormat, hash.get());
+  HashValue(rule.name(), hash.get());
+  HashValue(GetPublicKeyForRule(rule.name()), hash.get());
+  HashValue(rule.run_at(), hash.get());
+
+  const std::vector<std::string> url_patterns = rule.url_patterns();
+  HashValue(base::NumberToString(url_patterns.size()), hash.get());
+  for (const std::string& url_pattern : url_patterns)
+    HashValue(url_pattern, hash.get());
+
+  const std::vector<base::FilePath> scripts = rule.scripts();
+  HashValue(base::NumberToString(scripts.size()), hash.get());
+  for (const base::FilePath& script : scripts) {
+    HashValue(script.BaseName().AsUTF8Unsafe(), hash.get());
+    if (!HashFile(script, hash.get()))
+      return std::string();
+  }
+
+  if (!rule.messages().empty()) {
+    std::vector<base::FilePath> messages;
+    base::FileEnumerator enumerator(rule.messages(), true,
+                                    base::FileEnumerator::FILES);
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      messages.push_back(path);
+    }
+    std::sort(messages.begin(), messages.end());
+    HashValue(base::NumberToString(messages.size()), hash.get());
+    for (const base::FilePath& path : messages) {
+      base::FilePath relative_path;
+      rule.messages().AppendRelativePath(path, &relative_path);
+      HashValue(relative_path.AsUTF8Unsafe(), hash.get());
+      if (!HashFile(path, hash.get()))
+        return std::string();
+    }
+  }
+
+  uint8_t digest[crypto::kSHA256Length];
+  hash->Finish(digest, sizeof(digest));
+  return base::ToLowerASCII(base::HexEncode(digest, sizeof(digest)));
+}
+
+// Wraps a Greaselion rule in a component and writes it as an unpacked
+// extension to |extension_dir|. The extension is assembled in the profile's
+// install temp dir and moved into place once complete, so a partially
+// written directory is never picked up.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+bool WriteGreaselionRuleExtension(const greaselion::GreaselionRule& rule,
+                                  const base::FilePath& install_dir,
+                                  const base::FilePath& extension_dir) {
   base::FilePath install_temp_dir =
       extensions::file_util::GetInstallTempDir(install_dir);
   if (install_temp_dir.empty()) {
     LOG(ERROR) << "Could not get path to profile temp directory";
-    return absl::nullopt;
+    return false;
   }
 
   base::ScopedTempDir temp_dir;
   if (!temp_dir.CreateUniqueTempDirUnderPath(install_temp_dir)) {
     LOG(ERROR) << "Could not create Greaselion temp directory";
-    return absl::nullopt;
+    return false;
   }
 
   // Create the manifest
@@ -91,33 +192,12 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
   // see kModernManifestVersion in src/extensions/common/extension.cc
   root->SetIntPath(extensions::manifest_keys::kManifestVersion, 2);
 
-  // Create the public key.
-  // Greaselion scripts are not signed, but the public key for an extension
-  // doubles as its unique identity, and we need one of those, so we add the
-  // rule name to a known Brave domain and hash the result to create a
-  // public key.
-  char raw[crypto::kSHA256Length] = {0};
-  std::string key;
   std::string script_name = rule.name();
-  const base::CommandLine& command_line =
-      *base::CommandLine::ForCurrentProcess();
-  if (!command_line.HasSwitch(brave_component_updater::kUseGoUpdateDev) &&
-      !base::FeatureList::IsEnabled(
-          brave_component_updater::kUseDevUpdaterUrl)) {
-    crypto::SHA256HashString(UPDATER_DEV_ENDPOINT + script_name,
-                             raw,
-                             crypto::kSHA256Length);
-  } else {
-    crypto::SHA256HashString(UPDATER_PROD_ENDPOINT + script_name,
-                             raw,
-                             crypto::kSHA256Length);
-  }
-  base::Base64Encode(base::StringPiece(raw, crypto::kSHA256Length), &key);
-
   root->SetStringPath(extensions::manifest_keys::kName, script_name);
   root->SetStringPath(extensions::manifest_keys::kVersion, "1.0");
   root->SetStringPath(extensions::manifest_keys::kDescription, "");
-  root->SetStringPath(extensions::manifest_keys::kPublicKey, key);
+  root->SetStringPath(extensions::manifest_keys::kPublicKey,
+                      GetPublicKeyForRule(script_name));
   root->SetStringPath("incognito",
                       extensions::manifest_values::kIncognitoNotAllowed);
 
@@ -159,7 +239,7 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
   // files to disk.
   if (!serializer.Serialize(*root)) {
     LOG(ERROR) << "Could not write Greaselion manifest";
-    return absl::nullopt;
+    return false;
   }
 
   // Copy the messages directory to our extension directory.
@@ -169,7 +249,7 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
             temp_dir.GetPath().AppendASCII("_locales"), true)) {
       LOG(ERROR) << "Could not copy Greaselion messages directory at path: "
                  << rule.messages().LossyDisplayName();
-      return absl::nullopt;
+      return false;
     }
   }
 
@@ -179,37 +259,104 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
                         temp_dir.GetPath().Append(script.BaseName()))) {
       LOG(ERROR) << "Could not copy Greaselion script at path: "
           << script.LossyDisplayName();
-      return absl::nullopt;
+      return false;
     }
   }
 
+  // Calculate and write computed hashes. Resource paths are relative, so
+  // the hashes stay valid once the directory is moved into place.
+  absl::optional<extensions::ComputedHashes::Data> computed_hashes_data =
+      extensions::ComputedHashes::Compute(
+          temp_dir.GetPath(),
+          extension_misc::kContentVerificationDefaultBlockSize,
+          extensions::IsCancelledCallback(),
+          base::BindRepeating(&ShouldComputeHashesForResource));
+  if (computed_hashes_data) {
+    extensions::ComputedHashes(std::move(*computed_hashes_data))
+        .WriteToFile(
+            extensions::file_util::GetComputedHashesPath(temp_dir.GetPath()));
+  }
+
+  // Move the extension into place, replacing anything incomplete left behind
+  // under the same content hash.
+  const base::FilePath temp_path = temp_dir.Take();
+  if (!base::DeletePathRecursively(extension_dir) ||
+      !base::CreateDirectory(extension_dir.DirName()) ||
+      !base::Move(temp_path, extension_dir)) {
+    LOG(ERROR) << "Could not move Greaselion extension to "
+               << extension_dir.LossyDisplayName();
+    base::DeletePathRecursively(temp_path);
+    return false;
+  }
+  return true;
+}
+
+// Returns the extension for a Greaselion rule, converting the rule only if
+// no extension was converted from identical rule contents before. Converted
+// extensions persist under the install dir, keyed by content hash, so
+// toggling a rule on and off or restarting the browser reuses them.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+absl::optional<greaselion::GreaselionServiceImpl::GreaselionConvertedExtension>
+ConvertGreaselionRuleToExtensionOnTaskRunner(
+    const greaselion::GreaselionRule& rule,
+    const base::FilePath& install_dir) {
+  const std::string content_hash = ComputeRuleContentHash(rule);
+  if (content_hash.empty()) {
+    LOG(ERROR) << "Could not read Greaselion rule files";
+    return absl::nullopt;
+  }
+
+  const base::FilePath extension_dir =
+      GetConvertedExtensionsDir(install_dir).AppendASCII(content_hash);
+  bool written = false;
+  if (!base::PathExists(extension_dir.Append(extensions::kManifestFilename))) {
+    if (!WriteGreaselionRuleExtension(rule, install_dir, extension_dir))
+      return absl::nullopt;
+    written = true;
+  }
+
   std::string error;
   scoped_refptr<Extension> extension = extensions::file_util::LoadExtension(
-      temp_dir.GetPath(), ManifestLocation::kComponent, Extension::NO_FLAGS,
+      extension_dir, ManifestLocation::kComponent, Extension::NO_FLAGS,
       &error);
   if (!extension.get()) {
     LOG(ERROR) << "Could not load Greaselion extension";
     LOG(ERROR) << error;
+    // Don't keep reusing a directory that fails to load.
+    base::DeletePathRecursively(extension_dir);
     return absl::nullopt;
   }
 
-  // Calculate and write computed hashes.
-  absl::optional<extensions::ComputedHashes::Data> computed_hashes_data =
-      extensions::ComputedHashes::Compute(
-          extension->path(),
-          extension_misc::kContentVerificationDefaultBlockSize,
-          extensions::IsCancelledCallback(),
-          base::BindRepeating(&ShouldComputeHashesForResource));
-  if (computed_hashes_data) {
-    extensions::ComputedHashes(std::move(*computed_hashes_data))
-        .WriteToFile(
-            extensions::file_util::GetComputedHashesPath(extension->path()));
+  return std::make_pair(extension, written);
+}
+
+// Deletes converted extensions that no current rule maps to, e.g. after a
+// component update changed the rules. |install_dir| belongs to a single
+// profile, so nothing deleted here can be in use by another profile.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+void DeleteUnusedConvertedExtensionsOnTaskRunner(
+    const std::vector<greaselion::GreaselionRule>& rules,
+    const base::FilePath& install_dir) {
+  std::set<base::FilePath::StringType> content_hashes;
+  for (const greaselion::GreaselionRule& rule : rules) {
+    const std::string content_hash = ComputeRuleContentHash(rule);
+    if (!content_hash.empty()) {
+      content_hashes.insert(
+          base::FilePath::FromUTF8Unsafe(content_hash).value());
+    }
   }
 
-  // Take ownership of this temporary directory so it's deleted when
-  // the service exits
-  return std::make_pair(extension, std::move(temp_dir));
+  base::FileEnumerator enumerator(GetConvertedExtensionsDir(install_dir),
+                                  false, base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (!content_hashes.count(path.BaseName().value()))
+      base::DeletePathRecursively(path);
+  }
 }
+
 }  // namespace
 
 namespace greaselion {
@@ -262,28 +409,46 @@ void GreaselionServiceImpl::UpdateInstalledExtensions() {
     return;
   }
   update_in_progress_ = true;
-  if (greaselion_extensions_.empty()) {
-    // No Greaselion extensions are currently installed, so we can move on to
-    // the install phase immediately.
+
+  // Only unload the extensions of rules that no longer match. Everything is
+  // reloaded after the rules themselves changed, converting again is cheap
+  // then as unchanged rules map to the same converted extension.
+  std::set<std::string> matching_rules;
+  if (!rules_changed_) {
+    for (const std::unique_ptr<GreaselionRule>& rule :
+         *download_service_->rules()) {
+      if (rule->Matches(state_, browser_version_) &&
+          rule->has_unknown_preconditions() == false) {
+        matching_rules.insert(rule->name());
+      }
+    }
+  }
+  rules_changed_ = false;
+
+  DCHECK(pending_unloads_.empty());
+  for (const auto& installed_rule : installed_rules_) {
+    if (!matching_rules.count(installed_rule.first))
+      pending_unloads_.push_back(installed_rule.second);
+  }
+  if (pending_unloads_.empty()) {
     CreateAndInstallExtensions();
     return;
   }
 
-  // Make a copy of greaselion_extensions_ to iterate while the original vector
+  // Make a copy of pending_unloads_ to iterate while the original vector
   // changes.
-  std::vector<extensions::ExtensionId> extensions = greaselion_extensions_;
+  std::vector<extensions::ExtensionId> extensions = pending_unloads_;
   for (auto id : extensions) {
-    // We need to unload all the Greaselion extensions that are already
-    // installed. OnExtensionUnloaded will be called on each extension, where we
-    // will update the greaselion_extensions_ set. Once it's empty, that
-    // callback will call CreateAndInstallExtensions().
+    // OnExtensionUnloaded will be called on each extension, where we will
+    // update pending_unloads_. Once it's empty, that callback will call
+    // CreateAndInstallExtensions().
     extension_service_->UnloadExtension(
         id, extensions::UnloadedExtensionReason::UPDATE);
   }
 }
 
 void GreaselionServiceImpl::CreateAndInstallExtensions() {
-  DCHECK(greaselion_extensions_.empty());
+  DCHECK(pending_unloads_.empty());
   DCHECK(update_in_progress_);
   all_rules_installed_successfully_ = true;
   pending_installs_ = 0;
@@ -291,18 +456,20 @@ void GreaselionServiceImpl::CreateAndInstallExtensions() {
       download_service_->rules();
   for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
     if (rule->Matches(state_, browser_version_) &&
-        rule->has_unknown_preconditions() == false) {
+        rule->has_unknown_preconditions() == false &&
+        !installed_rules_.count(rule->name())) {
       pending_installs_ += 1;
     }
   }
   if (!pending_installs_) {
-    // no rules match, nothing else to do
+    // no new rules match, nothing else to do
     MaybeNotifyObservers();
     return;
   }
   for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
     if (rule->Matches(state_, browser_version_) &&
-        rule->has_unknown_preconditions() == false) {
+        rule->has_unknown_preconditions() == false &&
+        !installed_rules_.count(rule->name())) {
       // Convert script file to component extension. This must run on extension
       // file task runner, which was passed in in the constructor.
       GreaselionRule rule_copy(*rule);
@@ -311,12 +478,13 @@ void GreaselionServiceImpl::CreateAndInstallExtensions() {
           base::BindOnce(&ConvertGreaselionRuleToExtensionOnTaskRunner,
                          rule_copy, install_directory_),
           base::BindOnce(&GreaselionServiceImpl::PostConvert,
-                         weak_factory_.GetWeakPtr()));
+                         weak_factory_.GetWeakPtr(), rule->name()));
     }
   }
 }
 
 void GreaselionServiceImpl::PostConvert(
+    const std::string& rule_name,
     absl::optional<GreaselionConvertedExtension> converted_extension) {
   if (!converted_extension) {
     all_rules_installed_successfully_ = false;
@@ -324,8 +492,11 @@ void GreaselionServiceImpl::PostConvert(
     MaybeNotifyObservers();
     LOG(ERROR) << "Could not load Greaselion script";
   } else {
-    greaselion_extensions_.push_back(converted_extension->first->id());
-    extension_dirs_.push_back(std::move(converted_extension->second));
+    if (converted_extension->second)
+      converted_extensions_written_ += 1;
+    const extensions::ExtensionId& id = converted_extension->first->id();
+    installed_rules_[rule_name] = id;
+    greaselion_extensions_.push_back(id);
     extension_system_->ready().Post(
         FROM_HERE, base::BindOnce(&GreaselionServiceImpl::Install,
                                   weak_factory_.GetWeakPtr(),
@@ -363,7 +534,19 @@ void GreaselionServiceImpl::OnExtensionUnloaded(
     return;
   }
   greaselion_extensions_.erase(index);
-  if (update_in_progress_ && greaselion_extensions_.empty()) {
+  for (auto it = installed_rules_.begin(); it != installed_rules_.end(); ++it) {
+    if (it->second == extension->id()) {
+      installed_rules_.erase(it);
+      break;
+    }
+  }
+
+  auto pending_unload = std::find(pending_unloads_.begin(),
+                                  pending_unloads_.end(), extension->id());
+  if (pending_unload == pending_unloads_.end())
+    return;
+  pending_unloads_.erase(pending_unload);
+  if (update_in_progress_ && pending_unloads_.empty()) {
     // It's time!
     CreateAndInstallExtensions();
   }
@@ -385,6 +568,10 @@ void GreaselionServiceImpl::MaybeNotifyObservers() {
       update_pending_ = false;
       UpdateInstalledExtensions();
     } else {
+      if (delete_unused_converted_extensions_) {
+        delete_unused_converted_extensions_ = false;
+        DeleteUnusedConvertedExtensions();
+      }
       for (auto& observer : observers_)
         observer.OnExtensionsReady(this, all_rules_installed_successfully_);
     }
@@ -393,11 +580,27 @@ void GreaselionServiceImpl::MaybeNotifyObservers() {
 
 void GreaselionServiceImpl::OnRulesReady(
     GreaselionDownloadService* download_service) {
+  // Rules are matched by name, so extensions installed from the previous
+  // rules have to be replaced even if a rule of the same name still matches.
+  rules_changed_ = true;
+  delete_unused_converted_extensions_ = true;
+  UpdateInstalledExtensions();
   for (auto& observer : observers_) {
     observer.OnRulesReady(this);
   }
 }
 
+void GreaselionServiceImpl::DeleteUnusedConvertedExtensions() {
+  std::vector<GreaselionRule> rules;
+  for (const std::unique_ptr<GreaselionRule>& rule :
+       *download_service_->rules()) {
+    rules.emplace_back(*rule);
+  }
+  task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&DeleteUnusedConvertedExtensionsOnTaskRunner,
+                                std::move(rules), install_directory_));
+}
+
 void GreaselionServiceImpl::SetFeatureEnabled(GreaselionFeature feature,
                                               bool enabled) {
   DCHECK(feature >= 0 && feature < LAST_FEATURE);
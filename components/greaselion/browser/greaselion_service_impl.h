@@ -13,7 +13,6 @@
 #include <vector>
 
 #include "base/files/file_path.h"
-#include "base/files/scoped_temp_dir.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "base/path_service.h"
@@ -64,16 +63,24 @@ class GreaselionServiceImpl : public GreaselionService,
                            const extensions::Extension* extension,
                            extensions::UnloadedExtensionReason reason) override;
 
+  // A converted rule, and whether converting it wrote a new extension
+  // directory rather than reusing one converted earlier.
   using GreaselionConvertedExtension =
-      std::pair<scoped_refptr<extensions::Extension>, base::ScopedTempDir>;
+      std::pair<scoped_refptr<extensions::Extension>, bool>;
+
+  int converted_extensions_written_for_testing() const {
+    return converted_extensions_written_;
+  }
 
  private:
   void SetBrowserVersionForTesting(const base::Version& version) override;
   void CreateAndInstallExtensions();
   void PostConvert(
+      const std::string& rule_name,
       absl::optional<GreaselionConvertedExtension> converted_extension);
   void Install(scoped_refptr<extensions::Extension> extension);
   void MaybeNotifyObservers();
+  void DeleteUnusedConvertedExtensions();
 
   // GreaselionDownloadService::Observer:
   void OnRulesReady(GreaselionDownloadService* download_service) override;
@@ -87,11 +94,16 @@ class GreaselionServiceImpl : public GreaselionService,
   bool all_rules_installed_successfully_;
   bool update_in_progress_;
   bool update_pending_;
+  bool rules_changed_ = false;
+  bool delete_unused_converted_extensions_ = false;
   int pending_installs_;
+  int converted_extensions_written_ = 0;
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
   base::ObserverList<GreaselionService::Observer> observers_;
   std::vector<extensions::ExtensionId> greaselion_extensions_;
-  std::vector<base::ScopedTempDir> extension_dirs_;
+  // Rule name to the extension installed for it.
+  std::map<std::string, extensions::ExtensionId> installed_rules_;
+  std::vector<extensions::ExtensionId> pending_unloads_;
   base::Version browser_version_;
   base::WeakPtrFactory<GreaselionServiceImpl> weak_factory_;
 
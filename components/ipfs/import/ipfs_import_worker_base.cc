@@ -18,6 +18,7 @@
 #include "base/task/thread_pool.h"
 #include "base/task_runner_util.h"
 #include "base/time/time.h"
+#include "brave/components/ipfs/import/ipfs_multipart_streamer.h"
 #include "brave/components/ipfs/ipfs_constants.h"
 #include "brave/components/ipfs/ipfs_json_parser.h"
 #include "brave/components/ipfs/ipfs_utils.h"
@@ -36,6 +37,7 @@
 #include "net/http/http_response_headers.h"
 #include "net/http/http_status_code.h"
 #include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/resource_request_body.h"
 #include "services/network/public/cpp/simple_url_loader.h"
 #include "third_party/blink/public/mojom/blob/serialized_blob.mojom.h"
 #include "url/gurl.h"
@@ -80,24 +82,13 @@ void IpfsImportWorkerBase::ImportFile(const base::FilePath upload_file_path,
                                       const std::string& mime_type,
                                       const std::string& filename) {
   data_->filename = filename;
-
-  auto upload_callback = base::BindOnce(&IpfsImportWorkerBase::UploadData,
-                                        weak_factory_.GetWeakPtr());
-
-  base::ThreadPool::PostTaskAndReplyWithResult(
-      FROM_HERE, {base::MayBlock()},
-      base::BindOnce(&ipfs::CalculateFileSize, upload_file_path),
-      base::BindOnce(&CreateRequestForFile, upload_file_path,
-                     blob_context_getter_factory_, mime_type, filename,
-                     std::move(upload_callback)));
+  StreamData(
+      IpfsMultipartStreamer::ForFile(upload_file_path, mime_type, filename));
 }
 
 void IpfsImportWorkerBase::ImportFolder(const base::FilePath folder_path) {
-  auto upload_callback = base::BindOnce(&IpfsImportWorkerBase::UploadData,
-                                        weak_factory_.GetWeakPtr());
   data_->filename = folder_path.BaseName().MaybeAsASCII();
-  CreateRequestForFolder(folder_path, blob_context_getter_factory_,
-                         std::move(upload_callback));
+  StreamData(IpfsMultipartStreamer::ForFolder(folder_path));
 }
 
 void IpfsImportWorkerBase::ImportText(const std::string& text,
@@ -117,6 +108,20 @@ void IpfsImportWorkerBase::ImportText(const std::string& text,
                        std::move(upload_callback));
 }
 
+void IpfsImportWorkerBase::StreamData(
+    std::unique_ptr<IpfsMultipartStreamer> streamer) {
+  DCHECK(!streamer_);
+  streamer_ = std::move(streamer);
+  auto request = std::make_unique<network::ResourceRequest>();
+  request->request_body = new network::ResourceRequestBody();
+  request->request_body->SetToChunkedDataPipe(
+      streamer_->BindRemote(),
+      network::ResourceRequestBody::ReadOnlyOnce(true));
+  request->headers.SetHeader(net::HttpRequestHeaders::kContentType,
+                             streamer_->GetContentType());
+  UploadData(std::move(request));
+}
+
 void IpfsImportWorkerBase::UploadData(
     std::unique_ptr<network::ResourceRequest> request) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
@@ -174,8 +179,12 @@ void IpfsImportWorkerBase::OnImportAddComplete(
     success = ParseResponseBody(*response_body, data_.get());
   }
   url_loader_.reset();
+  streamer_.reset();
   if (success && !data_->hash.empty()) {
+    pending_post_add_steps_ = key_to_publish_.empty() ? 1 : 2;
     CreateBraveDirectory();
+    if (!key_to_publish_.empty())
+      PublishContent();
     return;
   }
   NotifyImportCompleted(IPFS_IMPORT_ERROR_ADD_FAILED);
@@ -194,7 +203,7 @@ void IpfsImportWorkerBase::CreateBraveDirectory() {
   url_loader_->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
       url_loader_factory_,
       base::BindOnce(&IpfsImportWorkerBase::OnImportDirectoryCreated,
-                     base::Unretained(this), directory));
+                     weak_factory_.GetWeakPtr(), directory));
 }
 
 void IpfsImportWorkerBase::OnImportDirectoryCreated(
@@ -211,7 +220,8 @@ void IpfsImportWorkerBase::OnImportDirectoryCreated(
     CopyFilesToBraveDirectory();
     return;
   }
-  NotifyImportCompleted(IPFS_IMPORT_ERROR_MKDIR_FAILED);
+  copy_state_ = IPFS_IMPORT_ERROR_MKDIR_FAILED;
+  OnPostAddStepDone();
 }
 
 void IpfsImportWorkerBase::CopyFilesToBraveDirectory() {
@@ -226,7 +236,7 @@ void IpfsImportWorkerBase::CopyFilesToBraveDirectory() {
   url_loader_->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
       url_loader_factory_,
       base::BindOnce(&IpfsImportWorkerBase::OnImportFilesMoved,
-                     base::Unretained(this)));
+                     weak_factory_.GetWeakPtr()));
 }
 
 void IpfsImportWorkerBase::OnImportFilesMoved(
@@ -241,35 +251,33 @@ void IpfsImportWorkerBase::OnImportFilesMoved(
     VLOG(1) << "error_code:" << error_code << " response_code:" << response_code
             << " response_body:" << *response_body;
   }
-  if (!data_->hash.empty() && !key_to_publish_.empty()) {
-    PublishContent();
-    return;
-  }
-  NotifyImportCompleted(success ? IPFS_IMPORT_SUCCESS
-                                : IPFS_IMPORT_ERROR_MOVE_FAILED);
+  copy_state_ = success ? IPFS_IMPORT_SUCCESS : IPFS_IMPORT_ERROR_MOVE_FAILED;
+  OnPostAddStepDone();
 }
 
 void IpfsImportWorkerBase::PublishContent() {
-  DCHECK(!url_loader_);
+  DCHECK(!publish_url_loader_);
   std::string from = "/ipfs/" + data_->hash;
   GURL url = net::AppendQueryParameter(
       server_endpoint_.Resolve(kAPIPublishNameEndpoint), "arg", from);
   url = net::AppendQueryParameter(url, "key", key_to_publish_);
 
-  url_loader_ = CreateURLLoader(url, "POST");
-  url_loader_->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
+  publish_url_loader_ = CreateURLLoader(url, "POST");
+  publish_url_loader_->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
       url_loader_factory_,
       base::BindOnce(&IpfsImportWorkerBase::OnContentPublished,
-                     base::Unretained(this)));
+                     weak_factory_.GetWeakPtr()));
 }
 
 void IpfsImportWorkerBase::OnContentPublished(
     std::unique_ptr<std::string> response_body) {
-  int error_code = url_loader_->NetError();
+  int error_code = publish_url_loader_->NetError();
   int response_code = -1;
-  if (url_loader_->ResponseInfo() && url_loader_->ResponseInfo()->headers)
-    response_code = url_loader_->ResponseInfo()->headers->response_code();
-  url_loader_.reset();
+  if (publish_url_loader_->ResponseInfo() &&
+      publish_url_loader_->ResponseInfo()->headers)
+    response_code =
+        publish_url_loader_->ResponseInfo()->headers->response_code();
+  publish_url_loader_.reset();
   bool success = (error_code == net::OK && response_code == net::HTTP_OK);
   if (success)
     data_->published_key = key_to_publish_;
@@ -278,8 +286,21 @@ void IpfsImportWorkerBase::OnContentPublished(
             << " response_body:" << *response_body;
   }
 
-  NotifyImportCompleted(success ? IPFS_IMPORT_SUCCESS
-                                : IPFS_IMPORT_ERROR_PUBLISH_FAILED);
+  publish_state_ =
+      success ? IPFS_IMPORT_SUCCESS : IPFS_IMPORT_ERROR_PUBLISH_FAILED;
+  OnPostAddStepDone();
+}
+
+void IpfsImportWorkerBase::OnPostAddStepDone() {
+  DCHECK_GT(pending_post_add_steps_, 0);
+  if (--pending_post_add_steps_ > 0)
+    return;
+  // A failed copy is not reported once the content is published, as it was
+  // when publishing followed the copy.
+  if (copy_state_ == IPFS_IMPORT_ERROR_MKDIR_FAILED)
+    return NotifyImportCompleted(copy_state_);
+  NotifyImportCompleted(key_to_publish_.empty() ? copy_state_
+                                                : publish_state_);
 }
 
 void IpfsImportWorkerBase::NotifyImportCompleted(ipfs::ImportState state) {
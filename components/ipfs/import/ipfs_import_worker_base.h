@@ -30,6 +30,8 @@ struct ResourceRequest;
 
 namespace ipfs {
 
+class IpfsMultipartStreamer;
+
 // A base class that implements steps for importing objects into ipfs.
 // In order to import an object it is necessary to create
 // an ImportWorker of the desired type, each worker can import only one object.
@@ -38,10 +40,12 @@ namespace ipfs {
 // Worker:
 //   1. Worker prepares a blob block of data to import
 // IpfsImportWorkerBase:
-//   2. Sends blob to ifps using IPFS api (/api/v0/add)
+//   2. Sends blob to ifps using IPFS api (/api/v0/add), files and folders
+//      are streamed from disk by IpfsMultipartStreamer
 //   3. Creates target directory for import using IPFS api(/api/v0/files/mkdir)
 //   4. Moves objects to target directory using IPFS api(/api/v0/files/cp)
 //   5. Publishes objects under passed IPNS key(/api/v0/name/publish)
+// Steps 3-4 and step 5 only depend on the added hash and run in parallel.
 class IpfsImportWorkerBase {
  public:
   IpfsImportWorkerBase(BlobContextGetterFactory* blob_context_getter_factory,
@@ -67,6 +71,7 @@ class IpfsImportWorkerBase {
   virtual void NotifyImportCompleted(ipfs::ImportState state);
 
  private:
+  void StreamData(std::unique_ptr<IpfsMultipartStreamer> streamer);
   void UploadData(std::unique_ptr<network::ResourceRequest> request);
 
   void OnImportAddComplete(std::unique_ptr<std::string> response_body);
@@ -80,12 +85,19 @@ class IpfsImportWorkerBase {
                          ipfs::ImportedData* data);
   void PublishContent();
   void OnContentPublished(std::unique_ptr<std::string> response_body);
+  // Called when either of the steps following the add is over.
+  void OnPostAddStepDone();
   ImportCompletedCallback callback_;
   std::unique_ptr<ipfs::ImportedData> data_;
 
   BlobContextGetterFactory* blob_context_getter_factory_ = nullptr;
   network::mojom::URLLoaderFactory* url_loader_factory_;
   std::unique_ptr<network::SimpleURLLoader> url_loader_;
+  std::unique_ptr<network::SimpleURLLoader> publish_url_loader_;
+  std::unique_ptr<IpfsMultipartStreamer> streamer_;
+  int pending_post_add_steps_ = 0;
+  ipfs::ImportState copy_state_ = IPFS_IMPORT_SUCCESS;
+  ipfs::ImportState publish_state_ = IPFS_IMPORT_SUCCESS;
   GURL server_endpoint_;
   std::string key_to_publish_;
   base::WeakPtrFactory<IpfsImportWorkerBase> weak_factory_;
@@ -0,0 +1,290 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ipfs/import/ipfs_multipart_streamer.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/task/thread_pool.h"
+#include "base/task_runner_util.h"
+#include "brave/components/ipfs/ipfs_constants.h"
+#include "brave/components/ipfs/ipfs_network_utils.h"
+#include "mojo/public/cpp/system/data_pipe_producer.h"
+#include "mojo/public/cpp/system/file_data_source.h"
+#include "mojo/public/cpp/system/string_data_source.h"
+#include "net/base/mime_util.h"
+#include "net/base/net_errors.h"
+
+namespace {
+
+bool GetRelativePathComponent(const base::FilePath& parent,
+                              const base::FilePath& child,
+                              base::FilePath::StringType* out) {
+  if (!parent.IsParent(child))
+    return false;
+
+  std::vector<base::FilePath::StringType> parent_components;
+  std::vector<base::FilePath::StringType> child_components;
+  parent.GetComponents(&parent_components);
+  child.GetComponents(&child_components);
+
+  size_t i = 0;
+  while (i < parent_components.size() &&
+         child_components[i] == parent_components[i]) {
+    ++i;
+  }
+
+  while (i < child_components.size()) {
+    out->append(child_components[i]);
+    if (++i < child_components.size())
+      out->append(FILE_PATH_LITERAL("/"));
+  }
+  return true;
+}
+
+}  // namespace
+
+namespace ipfs {
+
+IpfsMultipartStreamer::Entry::Entry() = default;
+IpfsMultipartStreamer::Entry::Entry(const Entry&) = default;
+IpfsMultipartStreamer::Entry::~Entry() = default;
+
+IpfsMultipartStreamer::Batch::Batch() = default;
+IpfsMultipartStreamer::Batch::Batch(Batch&&) = default;
+IpfsMultipartStreamer::Batch::~Batch() = default;
+
+IpfsMultipartStreamer::IpfsMultipartStreamer()
+    : mime_boundary_(net::GenerateMimeMultipartBoundary()),
+      file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {}
+
+IpfsMultipartStreamer::~IpfsMultipartStreamer() {
+  if (enumerator_)
+    file_task_runner_->DeleteSoon(FROM_HERE, std::move(enumerator_));
+}
+
+// static
+std::unique_ptr<IpfsMultipartStreamer> IpfsMultipartStreamer::ForFile(
+    const base::FilePath& path,
+    const std::string& mime_type,
+    const std::string& filename) {
+  std::unique_ptr<IpfsMultipartStreamer> streamer(new IpfsMultipartStreamer());
+  Entry entry;
+  entry.path = path;
+  entry.name = filename.empty() ? path.BaseName().MaybeAsASCII() : filename;
+  entry.mime_type = mime_type;
+  streamer->entries_.push_back(std::move(entry));
+  return streamer;
+}
+
+// static
+std::unique_ptr<IpfsMultipartStreamer> IpfsMultipartStreamer::ForFolder(
+    const base::FilePath& folder_path) {
+  std::unique_ptr<IpfsMultipartStreamer> streamer(new IpfsMultipartStreamer());
+  streamer->enumerator_ = std::make_unique<base::FileEnumerator>(
+      folder_path, true,
+      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
+  streamer->enumeration_parent_ = folder_path.DirName();
+  return streamer;
+}
+
+std::string IpfsMultipartStreamer::GetContentType() const {
+  std::string content_type = kIPFSImportMultipartContentType;
+  content_type += " boundary=";
+  content_type += mime_boundary_;
+  return content_type;
+}
+
+mojo::PendingRemote<network::mojom::ChunkedDataPipeGetter>
+IpfsMultipartStreamer::BindRemote() {
+  DCHECK(!receiver_.is_bound());
+  return receiver_.BindNewPipeAndPassRemote();
+}
+
+// static
+IpfsMultipartStreamer::Batch IpfsMultipartStreamer::EnumerateBatch(
+    base::FileEnumerator* enumerator,
+    const base::FilePath& parent) {
+  Batch batch;
+  while (batch.entries.size() < kEnumerationBatchSize) {
+    base::FilePath path = enumerator->Next();
+    if (path.empty()) {
+      batch.done = true;
+      break;
+    }
+    // Skip symlinks.
+    if (base::IsLink(path))
+      continue;
+    base::FilePath::StringType relative_path;
+    GetRelativePathComponent(parent, path, &relative_path);
+    Entry entry;
+    entry.path = path;
+    entry.name = base::FilePath(relative_path).MaybeAsASCII();
+    entry.absolute_path = path.MaybeAsASCII();
+    entry.is_directory = enumerator->GetInfo().IsDirectory();
+    entry.mime_type = entry.is_directory ? kDirectoryMimeType : kFileMimeType;
+    batch.entries.push_back(std::move(entry));
+  }
+  return batch;
+}
+
+// static
+base::File IpfsMultipartStreamer::OpenFile(const base::FilePath& path) {
+  return base::File(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+}
+
+void IpfsMultipartStreamer::GetSize(GetSizeCallback callback) {
+  if (finished_) {
+    std::move(callback).Run(status_, bytes_streamed_);
+    return;
+  }
+  get_size_callback_ = std::move(callback);
+}
+
+void IpfsMultipartStreamer::StartReading(
+    mojo::ScopedDataPipeProducerHandle pipe) {
+  // Entries are produced once, the body can't be replayed.
+  if (started_) {
+    Finish(net::ERR_FAILED);
+    return;
+  }
+  started_ = true;
+  producer_ = std::make_unique<mojo::DataPipeProducer>(std::move(pipe));
+  WriteNext();
+}
+
+void IpfsMultipartStreamer::WriteNext() {
+  if (finished_ || writing_)
+    return;
+
+  if (!entries_.empty()) {
+    Entry entry = std::move(entries_.front());
+    entries_.pop_front();
+    if (entry.is_directory) {
+      OnFileOpened(entry, base::File());
+      return;
+    }
+    writing_ = true;
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::BindOnce(&IpfsMultipartStreamer::OpenFile, entry.path),
+        base::BindOnce(&IpfsMultipartStreamer::OnFileOpened,
+                       weak_factory_.GetWeakPtr(), entry));
+    return;
+  }
+
+  if (enumerator_) {
+    if (enumerating_)
+      return;
+    enumerating_ = true;
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::BindOnce(&IpfsMultipartStreamer::EnumerateBatch,
+                       base::Unretained(enumerator_.get()),
+                       enumeration_parent_),
+        base::BindOnce(&IpfsMultipartStreamer::OnBatchEnumerated,
+                       weak_factory_.GetWeakPtr()));
+    return;
+  }
+
+  if (!footer_written_) {
+    footer_written_ = true;
+    std::string footer = "\r\n";
+    net::AddMultipartFinalDelimiterForUpload(mime_boundary_, &footer);
+    WriteString(std::move(footer));
+    return;
+  }
+
+  Finish(net::OK);
+}
+
+void IpfsMultipartStreamer::OnBatchEnumerated(Batch batch) {
+  enumerating_ = false;
+  for (auto& entry : batch.entries)
+    entries_.push_back(std::move(entry));
+  if (batch.done)
+    file_task_runner_->DeleteSoon(FROM_HERE, std::move(enumerator_));
+  WriteNext();
+}
+
+void IpfsMultipartStreamer::OnFileOpened(const Entry& entry, base::File file) {
+  writing_ = false;
+  if (!entry.is_directory && !file.IsValid()) {
+    Finish(net::FileErrorToNetError(file.error_details()));
+    return;
+  }
+
+  std::string header = "\r\n";
+  AddMultipartHeaderForUploadWithFileName(kFileValueName, entry.name,
+                                          entry.absolute_path, mime_boundary_,
+                                          entry.mime_type, &header);
+  entries_streamed_++;
+  WriteString(std::move(header));
+  if (entry.is_directory)
+    return;
+
+  // The header write completes first since the producer handles one write at
+  // a time; queue the file right behind it.
+  const int64_t length = file.GetLength();
+  if (length < 0) {
+    Finish(net::ERR_FAILED);
+    return;
+  }
+  auto source = std::make_unique<mojo::FileDataSource>(std::move(file));
+  source->SetRange(0, length);
+  pending_file_ = std::move(source);
+  pending_file_size_ = length;
+}
+
+void IpfsMultipartStreamer::WriteString(std::string data) {
+  DCHECK(!writing_);
+  writing_ = true;
+  chunk_ = std::move(data);
+  const int64_t size = chunk_.size();
+  producer_->Write(
+      std::make_unique<mojo::StringDataSource>(
+          chunk_, mojo::StringDataSource::AsyncWritingMode::
+                      STRING_STAYS_VALID_UNTIL_COMPLETION),
+      base::BindOnce(&IpfsMultipartStreamer::OnWritten,
+                     weak_factory_.GetWeakPtr(), size));
+}
+
+void IpfsMultipartStreamer::OnWritten(int64_t size, MojoResult result) {
+  writing_ = false;
+  chunk_.clear();
+  if (result != MOJO_RESULT_OK) {
+    Finish(net::ERR_FAILED);
+    return;
+  }
+  bytes_streamed_ += size;
+
+  if (pending_file_) {
+    writing_ = true;
+    producer_->Write(std::move(pending_file_),
+                     base::BindOnce(&IpfsMultipartStreamer::OnWritten,
+                                    weak_factory_.GetWeakPtr(),
+                                    pending_file_size_));
+    return;
+  }
+  WriteNext();
+}
+
+void IpfsMultipartStreamer::Finish(int32_t status) {
+  if (finished_)
+    return;
+  finished_ = true;
+  status_ = status;
+  producer_.reset();
+  pending_file_.reset();
+  if (get_size_callback_)
+    std::move(get_size_callback_).Run(status_, bytes_streamed_);
+}
+
+}  // namespace ipfs
@@ -0,0 +1,128 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_IPFS_IMPORT_IPFS_MULTIPART_STREAMER_H_
+#define BRAVE_COMPONENTS_IPFS_IMPORT_IPFS_MULTIPART_STREAMER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/circular_deque.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "mojo/public/cpp/bindings/pending_remote.h"
+#include "mojo/public/cpp/bindings/receiver.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/data_pipe_producer.h"
+#include "services/network/public/mojom/chunked_data_pipe_getter.mojom.h"
+
+namespace base {
+class FileEnumerator;
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace ipfs {
+
+// Produces the multipart/form-data body for /api/v0/add on demand, as a
+// chunked upload. Files and folders are enumerated and read lazily while the
+// network service drains the upload pipe, so memory use stays bounded by a
+// small batch of entries and the pipe capacity regardless of the import size.
+class IpfsMultipartStreamer : public network::mojom::ChunkedDataPipeGetter {
+ public:
+  struct Entry {
+    Entry();
+    Entry(const Entry&);
+    ~Entry();
+    base::FilePath path;
+    // Name relative to the import root, sent as the part file name.
+    std::string name;
+    // Sent as Abspath when not empty.
+    std::string absolute_path;
+    std::string mime_type;
+    bool is_directory = false;
+  };
+
+  // Number of directory entries enumerated per trip to the blocking sequence.
+  static constexpr size_t kEnumerationBatchSize = 64;
+
+  static std::unique_ptr<IpfsMultipartStreamer> ForFile(
+      const base::FilePath& path,
+      const std::string& mime_type,
+      const std::string& filename);
+  static std::unique_ptr<IpfsMultipartStreamer> ForFolder(
+      const base::FilePath& folder_path);
+
+  ~IpfsMultipartStreamer() override;
+
+  std::string GetContentType() const;
+  // The streamer must outlive the upload using the returned remote.
+  mojo::PendingRemote<network::mojom::ChunkedDataPipeGetter> BindRemote();
+
+  int64_t bytes_streamed() const { return bytes_streamed_; }
+  size_t entries_streamed() const { return entries_streamed_; }
+
+ private:
+  IpfsMultipartStreamer();
+
+  struct Batch {
+    Batch();
+    Batch(Batch&&);
+    ~Batch();
+    std::vector<Entry> entries;
+    bool done = false;
+  };
+
+  static Batch EnumerateBatch(base::FileEnumerator* enumerator,
+                              const base::FilePath& parent);
+  static base::File OpenFile(const base::FilePath& path);
+
+  // network::mojom::ChunkedDataPipeGetter
+  void GetSize(GetSizeCallback callback) override;
+  void StartReading(mojo::ScopedDataPipeProducerHandle pipe) override;
+
+  void WriteNext();
+  void OnBatchEnumerated(Batch batch);
+  void OnFileOpened(const Entry& entry, base::File file);
+  void WriteString(std::string data);
+  void OnWritten(int64_t size, MojoResult result);
+  void Finish(int32_t status);
+
+  std::string mime_boundary_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  // Lives on |file_task_runner_|, null once the folder is fully enumerated.
+  std::unique_ptr<base::FileEnumerator> enumerator_;
+  base::FilePath enumeration_parent_;
+  bool enumerating_ = false;
+
+  base::circular_deque<Entry> entries_;
+  std::unique_ptr<mojo::DataPipeProducer> producer_;
+  // Data |producer_| is currently writing.
+  std::string chunk_;
+  // File contents to write once the part header is written.
+  std::unique_ptr<mojo::DataPipeProducer::DataSource> pending_file_;
+  int64_t pending_file_size_ = 0;
+  bool writing_ = false;
+  bool footer_written_ = false;
+  bool started_ = false;
+  bool finished_ = false;
+  int32_t status_ = 0;
+  int64_t bytes_streamed_ = 0;
+  size_t entries_streamed_ = 0;
+  GetSizeCallback get_size_callback_;
+
+  mojo::Receiver<network::mojom::ChunkedDataPipeGetter> receiver_{this};
+  base::WeakPtrFactory<IpfsMultipartStreamer> weak_factory_{this};
+
+  IpfsMultipartStreamer(const IpfsMultipartStreamer&) = delete;
+  IpfsMultipartStreamer& operator=(const IpfsMultipartStreamer&) = delete;
+};
+
+}  // namespace ipfs
+
+#endif  // BRAVE_COMPONENTS_IPFS_IMPORT_IPFS_MULTIPART_STREAMER_H_
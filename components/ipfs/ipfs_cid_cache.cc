@@ -0,0 +1,284 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ipfs/ipfs_cid_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
+#include "base/task_runner_util.h"
+#include "base/time/time.h"
+#include "brave/components/ipfs/ipfs_utils.h"
+#include "crypto/sha2.h"
+#include "net/base/schemeful_site.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace {
+
+const base::FilePath::CharType kTempFileSuffix[] = FILE_PATH_LITERAL(".tmp");
+
+// CIDs and paths are hashed so names are safe for case insensitive file
+// systems, base58 CIDv0 being case sensitive.
+std::string HashName(const std::string& value) {
+  const std::string hash = crypto::SHA256HashString(value);
+  return base::ToLowerASCII(base::HexEncode(hash.data(), hash.size() / 2));
+}
+
+}  // namespace
+
+namespace ipfs {
+
+IpfsCidCache::CidEntry::CidEntry() = default;
+IpfsCidCache::CidEntry::CidEntry(const CidEntry&) = default;
+IpfsCidCache::CidEntry::~CidEntry() = default;
+
+IpfsCidCache::IpfsCidCache(const base::FilePath& cache_dir, int64_t max_size)
+    : cache_dir_(cache_dir),
+      max_size_(max_size),
+      index_(base::MRUCache<std::string, CidEntry>::NO_AUTO_EVICT),
+      file_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {
+  DCHECK(!cache_dir_.empty());
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&IpfsCidCache::LoadIndexOnFileTaskRunner, cache_dir_),
+      base::BindOnce(&IpfsCidCache::OnIndexLoaded,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+IpfsCidCache::~IpfsCidCache() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+// static
+std::string IpfsCidCache::MakeKey(const url::Origin& top_frame_origin,
+                                  const GURL& url) {
+  if (top_frame_origin.opaque())
+    return std::string();
+  const std::string immutable_key = GetImmutableIPFSCacheKey(url);
+  if (immutable_key.empty())
+    return std::string();
+  return net::SchemefulSite(top_frame_origin).Serialize() + " " +
+         immutable_key;
+}
+
+// static
+bool IpfsCidCache::SplitKey(const std::string& key,
+                            std::string* dir_name,
+                            std::string* file_name) {
+  // [top-frame site] [cid][/path], each site gets its own directory per CID.
+  const size_t space = key.find(' ');
+  if (space == std::string::npos || space == 0)
+    return false;
+  const size_t pos = key.find('/', space + 1);
+  if (pos == std::string::npos || pos == space + 1)
+    return false;
+  *dir_name = HashName(key.substr(0, pos));
+  *file_name = HashName(key.substr(pos));
+  return true;
+}
+
+// static
+IpfsCidCache::IndexEntries IpfsCidCache::LoadIndexOnFileTaskRunner(
+    const base::FilePath& dir) {
+  std::vector<std::pair<base::Time, std::pair<std::string, CidEntry>>> found;
+  base::FileEnumerator dirs(dir, false, base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath cid_dir = dirs.Next(); !cid_dir.empty();
+       cid_dir = dirs.Next()) {
+    CidEntry entry;
+    base::FileEnumerator files(cid_dir, false, base::FileEnumerator::FILES);
+    for (base::FilePath file = files.Next(); !file.empty();
+         file = files.Next()) {
+      // Leftovers of interrupted writes.
+      if (file.MatchesExtension(kTempFileSuffix)) {
+        base::DeleteFile(file);
+        continue;
+      }
+      const int64_t size = files.GetInfo().GetSize();
+      entry.files[file.BaseName().MaybeAsASCII()] = size;
+      entry.size += size;
+    }
+    found.push_back({dirs.GetInfo().GetLastModifiedTime(),
+                     {cid_dir.BaseName().MaybeAsASCII(), std::move(entry)}});
+  }
+  std::sort(found.begin(), found.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  IndexEntries entries;
+  for (auto& item : found)
+    entries.push_back(std::move(item.second));
+  return entries;
+}
+
+// static
+IpfsCidCache::ReadResult IpfsCidCache::ReadOnFileTaskRunner(
+    const base::FilePath& dir,
+    const std::string& file_name) {
+  ReadResult result;
+  std::string data;
+  if (!base::ReadFileToString(dir.AppendASCII(file_name), &data))
+    return result;
+  size_t pos = data.find('\n');
+  if (pos == std::string::npos)
+    return result;
+  // Entries written before headers were stored only have a mime type.
+  if (!base::StartsWith(data, "HTTP/", base::CompareCase::SENSITIVE))
+    return result;
+  // The directory modification time keeps the LRU order across restarts.
+  const base::Time now = base::Time::Now();
+  base::TouchFile(dir, now, now);
+  result.found = true;
+  result.raw_headers = data.substr(0, pos);
+  result.body = data.substr(pos + 1);
+  return result;
+}
+
+// static
+void IpfsCidCache::WriteOnFileTaskRunner(const base::FilePath& dir,
+                                         const std::string& file_name,
+                                         const std::string& data) {
+  if (!base::CreateDirectory(dir))
+    return;
+  const base::FilePath path = dir.AppendASCII(file_name);
+  const base::FilePath temp_path = path.AddExtension(kTempFileSuffix);
+  if (!base::WriteFile(temp_path, data) ||
+      !base::ReplaceFile(temp_path, path, nullptr)) {
+    base::DeleteFile(temp_path);
+  }
+}
+
+void IpfsCidCache::OnIndexLoaded(IndexEntries entries) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (cleared_before_load_)
+    entries.clear();
+  for (auto& entry : entries) {
+    total_size_ += entry.second.size;
+    index_.Put(entry.first, std::move(entry.second));
+  }
+  loaded_ = true;
+  EvictIfNeeded();
+  if (loaded_callback_for_testing_)
+    std::move(loaded_callback_for_testing_).Run();
+}
+
+void IpfsCidCache::Lookup(const std::string& key, LookupCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::string dir_name;
+  std::string file_name;
+  auto it = index_.end();
+  if (loaded_ && SplitKey(key, &dir_name, &file_name))
+    it = index_.Get(dir_name);
+  if (it == index_.end() || !it->second.files.count(file_name)) {
+    UMA_HISTOGRAM_BOOLEAN("Brave.IPFS.CidCacheHit", false);
+    std::move(callback).Run(false, std::string(), std::string());
+    return;
+  }
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&IpfsCidCache::ReadOnFileTaskRunner,
+                     cache_dir_.AppendASCII(dir_name), file_name),
+      base::BindOnce(&IpfsCidCache::OnRead, weak_ptr_factory_.GetWeakPtr(),
+                     dir_name, file_name, std::move(callback)));
+}
+
+void IpfsCidCache::OnRead(const std::string& dir_name,
+                          const std::string& file_name,
+                          LookupCallback callback,
+                          ReadResult result) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  UMA_HISTOGRAM_BOOLEAN("Brave.IPFS.CidCacheHit", result.found);
+  if (!result.found) {
+    // The file went missing behind our back, forget about it.
+    auto it = index_.Peek(dir_name);
+    if (it != index_.end()) {
+      auto file_it = it->second.files.find(file_name);
+      if (file_it != it->second.files.end()) {
+        it->second.size -= file_it->second;
+        total_size_ -= file_it->second;
+        it->second.files.erase(file_it);
+      }
+    }
+  }
+  std::move(callback).Run(result.found, result.raw_headers, result.body);
+}
+
+void IpfsCidCache::Store(const std::string& key,
+                         const std::string& raw_headers,
+                         const std::string& body) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::string dir_name;
+  std::string file_name;
+  if (!loaded_ || !SplitKey(key, &dir_name, &file_name) ||
+      raw_headers.find('\n') != std::string::npos)
+    return;
+  std::string data = raw_headers + "\n" + body;
+  const int64_t size = data.size();
+  if (size > kMaxEntrySize || size > max_size_)
+    return;
+
+  auto it = index_.Get(dir_name);
+  if (it == index_.end())
+    it = index_.Put(dir_name, CidEntry());
+  if (it->second.files.count(file_name))
+    return;
+  it->second.files[file_name] = size;
+  it->second.size += size;
+  total_size_ += size;
+
+  // Reads for this entry are posted to the same sequence, so they can't
+  // overtake the write.
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&IpfsCidCache::WriteOnFileTaskRunner,
+                     cache_dir_.AppendASCII(dir_name), file_name,
+                     std::move(data)));
+  EvictIfNeeded();
+}
+
+void IpfsCidCache::SetMaxSize(int64_t max_size) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  max_size_ = max_size;
+  EvictIfNeeded();
+}
+
+void IpfsCidCache::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!loaded_)
+    cleared_before_load_ = true;
+  index_.Clear();
+  total_size_ = 0;
+  // Posted after any pending write, so nothing stored so far survives.
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(base::IgnoreResult(&base::DeletePathRecursively),
+                     cache_dir_));
+}
+
+void IpfsCidCache::EvictIfNeeded() {
+  while (total_size_ > max_size_ && !index_.empty()) {
+    auto it = index_.rbegin();
+    total_size_ -= it->second.size;
+    RemoveDir(it->first);
+    index_.Erase(it);
+  }
+}
+
+void IpfsCidCache::RemoveDir(const std::string& dir_name) {
+  file_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(base::IgnoreResult(&base::DeletePathRecursively),
+                     cache_dir_.AppendASCII(dir_name)));
+}
+
+}  // namespace ipfs
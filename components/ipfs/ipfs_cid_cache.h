@@ -0,0 +1,137 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_IPFS_IPFS_CID_CACHE_H_
+#define BRAVE_COMPONENTS_IPFS_IPFS_CID_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+
+class GURL;
+
+namespace base {
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace url {
+class Origin;
+}  // namespace url
+
+namespace ipfs {
+
+// Disk backed cache for responses of immutable /ipfs/ resources, keyed by
+// MakeKey(). Content addressed by a CID never changes, so entries are never
+// revalidated; the only policy is a byte budget that evicts the least recently
+// used CIDs as a whole. Entries are partitioned by top-frame site like the
+// HTTP cache, so a site can't time lookups to learn what others loaded. The
+// index lives in memory on the owning sequence, file IO happens on a blocking
+// task runner.
+class IpfsCidCache {
+ public:
+  using LookupCallback = base::OnceCallback<void(bool found,
+                                                 const std::string& raw_headers,
+                                                 const std::string& body)>;
+
+  // Responses larger than this are never stored.
+  static constexpr int64_t kMaxEntrySize = 8 * 1024 * 1024;
+
+  IpfsCidCache(const base::FilePath& cache_dir, int64_t max_size);
+  ~IpfsCidCache();
+
+  // Returns the key for |url| loaded under |top_frame_origin|, or an empty
+  // string if the response can't be cached.
+  static std::string MakeKey(const url::Origin& top_frame_origin,
+                             const GURL& url);
+
+  // Runs |callback| with the cached response for |key|, whose headers are in
+  // net::HttpResponseHeaders::raw_headers() format. Lookups made before the
+  // index is loaded from disk are treated as misses.
+  void Lookup(const std::string& key, LookupCallback callback);
+  void Store(const std::string& key,
+             const std::string& raw_headers,
+             const std::string& body);
+  void SetMaxSize(int64_t max_size);
+  // Drops every entry, for clearing browsing data.
+  void Clear();
+
+  int64_t size() const { return total_size_; }
+  bool is_loaded() const { return loaded_; }
+  base::WeakPtr<IpfsCidCache> AsWeakPtr() {
+    return weak_ptr_factory_.GetWeakPtr();
+  }
+
+  void SetLoadedCallbackForTesting(base::OnceClosure callback) {
+    loaded_callback_for_testing_ = std::move(callback);
+  }
+
+  // Files stored for one CID, keyed by hashed path, with their sizes.
+  struct CidEntry {
+    CidEntry();
+    CidEntry(const CidEntry&);
+    ~CidEntry();
+    int64_t size = 0;
+    std::map<std::string, int64_t> files;
+  };
+  // Directory name and entry, least recently used first.
+  using IndexEntries = std::vector<std::pair<std::string, CidEntry>>;
+
+ private:
+  struct ReadResult {
+    bool found = false;
+    std::string raw_headers;
+    std::string body;
+  };
+
+  static bool SplitKey(const std::string& key,
+                       std::string* dir_name,
+                       std::string* file_name);
+  static IndexEntries LoadIndexOnFileTaskRunner(const base::FilePath& dir);
+  static ReadResult ReadOnFileTaskRunner(const base::FilePath& dir,
+                                         const std::string& file_name);
+  static void WriteOnFileTaskRunner(const base::FilePath& dir,
+                                    const std::string& file_name,
+                                    const std::string& data);
+
+  void OnIndexLoaded(IndexEntries entries);
+  void OnRead(const std::string& dir_name,
+              const std::string& file_name,
+              LookupCallback callback,
+              ReadResult result);
+  void EvictIfNeeded();
+  void RemoveDir(const std::string& dir_name);
+
+  const base::FilePath cache_dir_;
+  int64_t max_size_;
+  int64_t total_size_ = 0;
+  bool loaded_ = false;
+  // Clear() ran before the index was loaded, whatever the load finds is
+  // being deleted.
+  bool cleared_before_load_ = false;
+  base::MRUCache<std::string, CidEntry> index_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  base::OnceClosure loaded_callback_for_testing_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<IpfsCidCache> weak_ptr_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(IpfsCidCache);
+};
+
+}  // namespace ipfs
+
+#endif  // BRAVE_COMPONENTS_IPFS_IPFS_CID_CACHE_H_
@@ -0,0 +1,138 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ipfs/ipfs_cid_cache_body_tee.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "brave/components/ipfs/ipfs_cid_cache.h"
+#include "mojo/public/cpp/system/data_pipe_producer.h"
+#include "mojo/public/cpp/system/string_data_source.h"
+
+namespace ipfs {
+
+// static
+base::WeakPtr<IpfsCidCacheBodyTee> IpfsCidCacheBodyTee::Start(
+    mojo::ScopedDataPipeConsumerHandle source,
+    mojo::ScopedDataPipeProducerHandle destination,
+    base::WeakPtr<IpfsCidCache> cache,
+    const std::string& key,
+    const std::string& raw_headers) {
+  // Deletes itself.
+  auto* tee = new IpfsCidCacheBodyTee(std::move(source), std::move(destination),
+                                      std::move(cache), key, raw_headers);
+  return tee->weak_ptr_factory_.GetWeakPtr();
+}
+
+IpfsCidCacheBodyTee::IpfsCidCacheBodyTee(
+    mojo::ScopedDataPipeConsumerHandle source,
+    mojo::ScopedDataPipeProducerHandle destination,
+    base::WeakPtr<IpfsCidCache> cache,
+    const std::string& key,
+    const std::string& raw_headers)
+    : source_(std::move(source)),
+      source_watcher_(FROM_HERE,
+                      mojo::SimpleWatcher::ArmingPolicy::MANUAL,
+                      base::SequencedTaskRunnerHandle::Get()),
+      producer_(std::make_unique<mojo::DataPipeProducer>(
+          std::move(destination))),
+      cache_(std::move(cache)),
+      key_(key),
+      raw_headers_(raw_headers) {
+  source_watcher_.Watch(
+      source_.get(),
+      MOJO_HANDLE_SIGNAL_READABLE | MOJO_HANDLE_SIGNAL_PEER_CLOSED,
+      base::BindRepeating(&IpfsCidCacheBodyTee::OnSourceReadable,
+                          base::Unretained(this)));
+  source_watcher_.ArmOrNotify();
+}
+
+IpfsCidCacheBodyTee::~IpfsCidCacheBodyTee() = default;
+
+void IpfsCidCacheBodyTee::OnLoadComplete(bool success) {
+  if (load_completed_)
+    return;
+  load_completed_ = true;
+  load_succeeded_ = success;
+  MaybeFinish();
+}
+
+void IpfsCidCacheBodyTee::OnSourceReadable(MojoResult result) {
+  ReadMore();
+}
+
+void IpfsCidCacheBodyTee::ReadMore() {
+  if (!source_ || !in_flight_.empty())
+    return;
+
+  const void* data = nullptr;
+  uint32_t num_bytes = 0;
+  MojoResult result =
+      source_->BeginReadData(&data, &num_bytes, MOJO_READ_DATA_FLAG_NONE);
+  if (result == MOJO_RESULT_SHOULD_WAIT) {
+    source_watcher_.ArmOrNotify();
+    return;
+  }
+  if (result != MOJO_RESULT_OK) {
+    // The network side closed the pipe: the whole body went through.
+    source_watcher_.Cancel();
+    source_.reset();
+    drained_ = true;
+    MaybeFinish();
+    return;
+  }
+
+  const char* chars = static_cast<const char*>(data);
+  in_flight_.assign(chars, num_bytes);
+  if (cacheable_) {
+    if (body_.size() + num_bytes >
+        static_cast<size_t>(IpfsCidCache::kMaxEntrySize)) {
+      cacheable_ = false;
+      body_.clear();
+      body_.shrink_to_fit();
+    } else {
+      body_.append(chars, num_bytes);
+    }
+  }
+  source_->EndReadData(num_bytes);
+
+  producer_->Write(
+      std::make_unique<mojo::StringDataSource>(
+          in_flight_, mojo::StringDataSource::AsyncWritingMode::
+                          STRING_STAYS_VALID_UNTIL_COMPLETION),
+      base::BindOnce(&IpfsCidCacheBodyTee::OnWrite,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+void IpfsCidCacheBodyTee::OnWrite(MojoResult result) {
+  in_flight_.clear();
+  if (result != MOJO_RESULT_OK) {
+    // The consumer went away, nothing left to forward or to trust.
+    producer_.reset();
+    source_watcher_.Cancel();
+    source_.reset();
+    cacheable_ = false;
+    drained_ = true;
+    MaybeFinish();
+    return;
+  }
+  ReadMore();
+}
+
+void IpfsCidCacheBodyTee::MaybeFinish() {
+  if (!drained_ || !in_flight_.empty())
+    return;
+  // Closing the producer signals the end of the body to the consumer.
+  producer_.reset();
+  if (!load_completed_)
+    return;
+  if (load_succeeded_ && cacheable_ && cache_)
+    cache_->Store(key_, raw_headers_, body_);
+  delete this;
+}
+
+}  // namespace ipfs
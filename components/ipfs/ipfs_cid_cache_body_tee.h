@@ -0,0 +1,79 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_IPFS_IPFS_CID_CACHE_BODY_TEE_H_
+#define BRAVE_COMPONENTS_IPFS_IPFS_CID_CACHE_BODY_TEE_H_
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/simple_watcher.h"
+
+namespace mojo {
+class DataPipeProducer;
+}  // namespace mojo
+
+namespace ipfs {
+
+class IpfsCidCache;
+
+// Forwards a response body from |source| to |destination| while keeping a
+// copy for IpfsCidCache. The copy is stored only once the loader reports a
+// successful completion through OnLoadComplete() and the whole body went
+// through. Reading from |source| pauses while a chunk is being written, so a
+// slow consumer pushes back on the network rather than buffering here. Owns
+// itself and goes away once forwarding is over and the load result is known.
+class IpfsCidCacheBodyTee {
+ public:
+  static base::WeakPtr<IpfsCidCacheBodyTee> Start(
+      mojo::ScopedDataPipeConsumerHandle source,
+      mojo::ScopedDataPipeProducerHandle destination,
+      base::WeakPtr<IpfsCidCache> cache,
+      const std::string& key,
+      const std::string& raw_headers);
+
+  void OnLoadComplete(bool success);
+
+ private:
+  IpfsCidCacheBodyTee(mojo::ScopedDataPipeConsumerHandle source,
+                      mojo::ScopedDataPipeProducerHandle destination,
+                      base::WeakPtr<IpfsCidCache> cache,
+                      const std::string& key,
+                      const std::string& raw_headers);
+  ~IpfsCidCacheBodyTee();
+
+  void OnSourceReadable(MojoResult result);
+  void ReadMore();
+  void OnWrite(MojoResult result);
+  void MaybeFinish();
+
+  mojo::ScopedDataPipeConsumerHandle source_;
+  mojo::SimpleWatcher source_watcher_;
+  std::unique_ptr<mojo::DataPipeProducer> producer_;
+  base::WeakPtr<IpfsCidCache> cache_;
+  const std::string key_;
+  const std::string raw_headers_;
+
+  // Data |producer_| is currently writing. |source| is not read while this
+  // is non-empty.
+  std::string in_flight_;
+  // The copy to store, dropped once it grows over the entry size limit.
+  std::string body_;
+  bool cacheable_ = true;
+  bool drained_ = false;
+  bool load_completed_ = false;
+  bool load_succeeded_ = false;
+
+  base::WeakPtrFactory<IpfsCidCacheBodyTee> weak_ptr_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(IpfsCidCacheBodyTee);
+};
+
+}  // namespace ipfs
+
+#endif  // BRAVE_COMPONENTS_IPFS_IPFS_CID_CACHE_BODY_TEE_H_
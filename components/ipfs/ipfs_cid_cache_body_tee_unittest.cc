@@ -0,0 +1,128 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ipfs/ipfs_cid_cache_body_tee.h"
+
+#include <memory>
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "brave/components/ipfs/ipfs_cid_cache.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ipfs {
+
+namespace {
+
+constexpr uint32_t kSourceCapacity = 1024;
+constexpr uint32_t kDestinationCapacity = 64;
+constexpr char kHeaders[] = "HTTP/1.1 200 OK";
+
+// Writes as much of |data| as fits and returns the number of bytes written.
+uint32_t WriteSome(mojo::DataPipeProducerHandle producer,
+                   const std::string& data) {
+  uint32_t num_bytes = data.size();
+  if (producer.WriteData(data.data(), &num_bytes,
+                         MOJO_WRITE_DATA_FLAG_NONE) != MOJO_RESULT_OK)
+    return 0;
+  return num_bytes;
+}
+
+}  // namespace
+
+class IpfsCidCacheBodyTeeUnitTest : public testing::Test {
+ public:
+  IpfsCidCacheBodyTeeUnitTest() = default;
+  ~IpfsCidCacheBodyTeeUnitTest() override = default;
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    cache_ = std::make_unique<IpfsCidCache>(temp_dir_.GetPath(), 1024 * 1024);
+    task_environment_.RunUntilIdle();
+  }
+
+  // Reads everything currently available from |consumer| into |out|.
+  void ReadAvailable(mojo::DataPipeConsumerHandle consumer, std::string* out) {
+    char buffer[kDestinationCapacity];
+    uint32_t num_bytes = sizeof(buffer);
+    while (consumer.ReadData(buffer, &num_bytes, MOJO_READ_DATA_FLAG_NONE) ==
+           MOJO_RESULT_OK) {
+      out->append(buffer, num_bytes);
+      num_bytes = sizeof(buffer);
+    }
+  }
+
+  bool Lookup(const std::string& key, std::string* body) {
+    bool result = false;
+    cache_->Lookup(key, base::BindOnce(
+                            [](bool* result, std::string* body, bool found,
+                               const std::string& raw_headers,
+                               const std::string& found_body) {
+                              *result = found;
+                              *body = found_body;
+                            },
+                            &result, body));
+    task_environment_.RunUntilIdle();
+    return result;
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<IpfsCidCache> cache_;
+};
+
+TEST_F(IpfsCidCacheBodyTeeUnitTest, StopsReadingWhileDestinationIsFull) {
+  mojo::ScopedDataPipeProducerHandle source_producer;
+  mojo::ScopedDataPipeConsumerHandle source_consumer;
+  ASSERT_EQ(mojo::CreateDataPipe(kSourceCapacity, source_producer,
+                                 source_consumer),
+            MOJO_RESULT_OK);
+  mojo::ScopedDataPipeProducerHandle destination_producer;
+  mojo::ScopedDataPipeConsumerHandle destination_consumer;
+  ASSERT_EQ(mojo::CreateDataPipe(kDestinationCapacity, destination_producer,
+                                 destination_consumer),
+            MOJO_RESULT_OK);
+
+  auto tee = IpfsCidCacheBodyTee::Start(
+      std::move(source_consumer), std::move(destination_producer),
+      cache_->AsWeakPtr(), "https://a.test QmA/1", kHeaders);
+
+  const std::string chunk(kSourceCapacity, 'x');
+  std::string expected;
+  ASSERT_EQ(WriteSome(source_producer.get(), chunk), kSourceCapacity);
+  expected += chunk;
+  task_environment_.RunUntilIdle();
+
+  // The first chunk is stuck behind the unread destination, so the tee must
+  // leave the second one in the source pipe instead of buffering it.
+  ASSERT_EQ(WriteSome(source_producer.get(), chunk), kSourceCapacity);
+  expected += chunk;
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(WriteSome(source_producer.get(), "y"), 0u);
+
+  std::string received;
+  while (received.size() < expected.size()) {
+    ReadAvailable(destination_consumer.get(), &received);
+    task_environment_.RunUntilIdle();
+  }
+  source_producer.reset();
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(received, expected);
+
+  ASSERT_TRUE(tee);
+  tee->OnLoadComplete(true);
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(tee);
+
+  std::string body;
+  EXPECT_TRUE(Lookup("https://a.test QmA/1", &body));
+  EXPECT_EQ(body, expected);
+}
+
+}  // namespace ipfs
@@ -0,0 +1,198 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ipfs/ipfs_cid_cache.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace ipfs {
+
+namespace {
+
+constexpr char kHeaders[] = "HTTP/1.1 200 OK";
+
+}  // namespace
+
+class IpfsCidCacheUnitTest : public testing::Test {
+ public:
+  IpfsCidCacheUnitTest() = default;
+  ~IpfsCidCacheUnitTest() override = default;
+
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  std::unique_ptr<IpfsCidCache> CreateCache(int64_t max_size) {
+    auto cache = std::make_unique<IpfsCidCache>(temp_dir_.GetPath(), max_size);
+    task_environment_.RunUntilIdle();
+    EXPECT_TRUE(cache->is_loaded());
+    return cache;
+  }
+
+  bool Lookup(IpfsCidCache* cache,
+              const std::string& key,
+              std::string* raw_headers = nullptr,
+              std::string* body = nullptr) {
+    bool result = false;
+    cache->Lookup(key, base::BindOnce(
+                           [](bool* result, std::string* raw_headers,
+                              std::string* body, bool found,
+                              const std::string& found_raw_headers,
+                              const std::string& found_body) {
+                             *result = found;
+                             if (raw_headers)
+                               *raw_headers = found_raw_headers;
+                             if (body)
+                               *body = found_body;
+                           },
+                           &result, raw_headers, body));
+    task_environment_.RunUntilIdle();
+    return result;
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(IpfsCidCacheUnitTest, StoreAndLookup) {
+  base::HistogramTester histogram_tester;
+  auto cache = CreateCache(1024);
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmYbK4/index.html"));
+
+  const std::string headers(
+      "HTTP/1.1 200 OK\0Content-Type: text/html; charset=utf-8\0\0", 56);
+  cache->Store("https://a.test QmYbK4/index.html", headers, "<p>\nhi</p>");
+  std::string raw_headers;
+  std::string body;
+  EXPECT_TRUE(Lookup(cache.get(), "https://a.test QmYbK4/index.html",
+                     &raw_headers, &body));
+  EXPECT_EQ(raw_headers, headers);
+  EXPECT_EQ(body, "<p>\nhi</p>");
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmYbK4/other.html"));
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test bafybeih/index.html"));
+
+  histogram_tester.ExpectBucketCount("Brave.IPFS.CidCacheHit", true, 1);
+  histogram_tester.ExpectBucketCount("Brave.IPFS.CidCacheHit", false, 3);
+}
+
+TEST_F(IpfsCidCacheUnitTest, PersistsAcrossInstances) {
+  auto cache = CreateCache(1024);
+  cache->Store("https://a.test QmYbK4/a.png", kHeaders, "png");
+  task_environment_.RunUntilIdle();
+  cache.reset();
+
+  cache = CreateCache(1024);
+  EXPECT_EQ(cache->size(), static_cast<int64_t>(strlen(kHeaders) + 4));
+  std::string body;
+  EXPECT_TRUE(
+      Lookup(cache.get(), "https://a.test QmYbK4/a.png", nullptr, &body));
+  EXPECT_EQ(body, "png");
+}
+
+TEST_F(IpfsCidCacheUnitTest, TreatsEntriesWithoutHeadersAsMisses) {
+  auto cache = CreateCache(1024);
+  cache->Store("https://a.test QmYbK4/a.png", kHeaders, "png");
+  task_environment_.RunUntilIdle();
+
+  // Rewrite the entry in the old format, which only kept the mime type.
+  base::FileEnumerator files(temp_dir_.GetPath(), true,
+                             base::FileEnumerator::FILES);
+  base::FilePath file = files.Next();
+  ASSERT_FALSE(file.empty());
+  ASSERT_TRUE(base::WriteFile(file, "image/png\npng"));
+
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmYbK4/a.png"));
+}
+
+TEST_F(IpfsCidCacheUnitTest, EvictsLeastRecentlyUsedCid) {
+  const std::string body(40, 'x');
+  auto cache = CreateCache(120);
+  cache->Store("https://a.test QmA/1", kHeaders, body);
+  cache->Store("https://a.test QmB/1", kHeaders, body);
+  // Touch QmA so QmB becomes the least recently used CID.
+  EXPECT_TRUE(Lookup(cache.get(), "https://a.test QmA/1"));
+  cache->Store("https://a.test QmC/1", kHeaders, body);
+
+  EXPECT_TRUE(Lookup(cache.get(), "https://a.test QmA/1"));
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmB/1"));
+  EXPECT_TRUE(Lookup(cache.get(), "https://a.test QmC/1"));
+  EXPECT_LE(cache->size(), 120);
+
+  cache->SetMaxSize(0);
+  EXPECT_EQ(cache->size(), 0);
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmA/1"));
+}
+
+TEST_F(IpfsCidCacheUnitTest, SkipsOversizedAndInvalidEntries) {
+  auto cache = CreateCache(64);
+  cache->Store("https://a.test QmA/1", kHeaders, std::string(64, 'x'));
+  cache->Store("https://a.test QmA", kHeaders, "x");
+  cache->Store("https://a.test QmA/2", "HTTP/1.1 200 OK\nX-Injected: 1", "x");
+  EXPECT_EQ(cache->size(), 0);
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmA/1"));
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmA/2"));
+}
+
+TEST_F(IpfsCidCacheUnitTest, MakeKey) {
+  const GURL url(
+      "https://dweb.link/ipfs/QmfM2r8seH2GiRaC4esTjeraXEachRt8ZsSeGaWTPLyMoG/"
+      "index.html");
+  EXPECT_EQ(IpfsCidCache::MakeKey(
+                url::Origin::Create(GURL("https://www.a.test/page")), url),
+            "https://a.test QmfM2r8seH2GiRaC4esTjeraXEachRt8ZsSeGaWTPLyMoG/"
+            "index.html");
+  EXPECT_EQ(IpfsCidCache::MakeKey(url::Origin(), url), "");
+  EXPECT_EQ(IpfsCidCache::MakeKey(url::Origin::Create(GURL("https://a.test")),
+                                  GURL("https://a.test/index.html")),
+            "");
+}
+
+TEST_F(IpfsCidCacheUnitTest, PartitionsByTopFrameSite) {
+  auto cache = CreateCache(1024);
+  cache->Store("https://a.test QmA/1", kHeaders, "a");
+  EXPECT_TRUE(Lookup(cache.get(), "https://a.test QmA/1"));
+  EXPECT_FALSE(Lookup(cache.get(), "https://b.test QmA/1"));
+  EXPECT_FALSE(Lookup(cache.get(), "QmA/1"));
+}
+
+TEST_F(IpfsCidCacheUnitTest, Clear) {
+  auto cache = CreateCache(1024);
+  cache->Store("https://a.test QmA/1", kHeaders, "a");
+  cache->Clear();
+  EXPECT_EQ(cache->size(), 0);
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmA/1"));
+
+  // Nothing comes back from disk either.
+  cache.reset();
+  cache = CreateCache(1024);
+  EXPECT_EQ(cache->size(), 0);
+
+  // Clearing before the index is loaded drops what the load finds.
+  cache->Store("https://a.test QmA/1", kHeaders, "a");
+  task_environment_.RunUntilIdle();
+  cache = std::make_unique<IpfsCidCache>(temp_dir_.GetPath(), 1024);
+  cache->Clear();
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(cache->is_loaded());
+  EXPECT_EQ(cache->size(), 0);
+  EXPECT_FALSE(Lookup(cache.get(), "https://a.test QmA/1"));
+
+  // The cache keeps working afterwards.
+  cache->Store("https://a.test QmA/1", kHeaders, "a");
+  EXPECT_TRUE(Lookup(cache.get(), "https://a.test QmA/1"));
+}
+
+}  // namespace ipfs
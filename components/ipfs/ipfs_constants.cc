@@ -44,4 +44,5 @@ const char kFileValueName[] = "file";
 const char kFileMimeType[] = "application/octet-stream";
 const char kDirectoryMimeType[] = "application/x-directory";
 const char kIPFSImportTextMimeType[] = "application/octet-stream";
+const char kIpfsCidCacheDirName[] = "IpfsCidCache";
 }  // namespace ipfs
@@ -41,6 +41,9 @@ extern const char kFileValueName[];
 extern const char kFileMimeType[];
 extern const char kDirectoryMimeType[];
 extern const char kIPFSImportTextMimeType[];
+extern const char kIpfsCidCacheDirName[];
+
+constexpr int kDefaultCidCacheMaxSizeMB = 256;
 
 // Keep it synced with IPFSResolveMethodTypes in
 // browser/resources/settings/brave_ipfs_page/brave_ipfs_page.js
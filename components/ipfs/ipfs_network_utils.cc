@@ -12,11 +12,9 @@
 
 #include "base/callback.h"
 #include "base/check.h"
-#include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/guid.h"
 #include "base/task/post_task.h"
-#include "base/task/thread_pool.h"
 #include "brave/components/ipfs/blob_context_getter_factory.h"
 #include "brave/components/ipfs/buildflags/buildflags.h"
 #include "brave/components/ipfs/ipfs_constants.h"
@@ -57,41 +55,6 @@ net::NetworkTrafficAnnotationTag GetIpfsNetworkTrafficAnnotationTag() {
 }
 
 #if BUILDFLAG(ENABLE_IPFS_LOCAL_NODE)
-struct ImportFileInfo {
-  ImportFileInfo(base::FilePath full_path,
-                 base::FileEnumerator::FileInfo information) {
-    path = full_path;
-    info = information;
-  }
-  base::FilePath path;
-  base::FileEnumerator::FileInfo info;
-};
-
-bool GetRelativePathComponent(const base::FilePath& parent,
-                              const base::FilePath& child,
-                              base::FilePath::StringType* out) {
-  if (!parent.IsParent(child))
-    return false;
-
-  std::vector<base::FilePath::StringType> parent_components;
-  std::vector<base::FilePath::StringType> child_components;
-  parent.GetComponents(&parent_components);
-  child.GetComponents(&child_components);
-
-  size_t i = 0;
-  while (i < parent_components.size() &&
-         child_components[i] == parent_components[i]) {
-    ++i;
-  }
-
-  while (i < child_components.size()) {
-    out->append(child_components[i]);
-    if (++i < child_components.size())
-      out->append(FILE_PATH_LITERAL("/"));
-  }
-  return true;
-}
-
 std::unique_ptr<storage::BlobDataBuilder> BuildBlobWithText(
     const std::string& text,
     std::string mime_type,
@@ -135,35 +98,6 @@ std::unique_ptr<storage::BlobDataBuilder> BuildBlobWithFile(
   return blob_builder;
 }
 
-std::unique_ptr<storage::BlobDataBuilder> BuildBlobWithFolder(
-    base::FilePath upload_path,
-    std::string mime_boundary,
-    std::vector<ImportFileInfo> files) {
-  auto blob_builder =
-      std::make_unique<storage::BlobDataBuilder>(base::GenerateGUID());
-  for (const auto& info : files) {
-    std::string data_header;
-    base::FilePath::StringType relative_path;
-    GetRelativePathComponent(upload_path, info.path, &relative_path);
-
-    std::string mime_type = info.info.IsDirectory() ? ipfs::kDirectoryMimeType
-                                                    : ipfs::kFileMimeType;
-    data_header.append("\r\n");
-    ipfs::AddMultipartHeaderForUploadWithFileName(
-        ipfs::kFileValueName, base::FilePath(relative_path).MaybeAsASCII(),
-        info.path.MaybeAsASCII(), mime_boundary, mime_type, &data_header);
-    blob_builder->AppendData(data_header);
-    if (mime_type == ipfs::kFileMimeType) {
-      blob_builder->AppendFile(info.path, 0, info.info.GetSize(), base::Time());
-    }
-  }
-
-  std::string post_data_footer = "\r\n";
-  net::AddMultipartFinalDelimiterForUpload(mime_boundary, &post_data_footer);
-  blob_builder->AppendData(post_data_footer);
-
-  return blob_builder;
-}
 #endif
 
 }  // namespace
@@ -270,53 +204,6 @@ void CreateRequestForFile(
       std::move(request_callback));
 }
 
-std::vector<ImportFileInfo> EnumerateDirectoryFiles(base::FilePath dir_path) {
-  std::vector<ImportFileInfo> files;
-  base::FileEnumerator file_enum(
-      dir_path, true,
-      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
-  for (base::FilePath enum_path = file_enum.Next(); !enum_path.empty();
-       enum_path = file_enum.Next()) {
-    // Skip symlinks.
-    if (base::IsLink(enum_path))
-      continue;
-    files.push_back(ImportFileInfo(enum_path, file_enum.GetInfo()));
-  }
-
-  return files;
-}
-
-void CreateRequestForFileList(
-    ResourceRequestGetter request_callback,
-    ipfs::BlobContextGetterFactory* blob_context_getter_factory,
-    const base::FilePath& folder_path,
-    std::vector<ImportFileInfo> files) {
-  std::string mime_boundary = net::GenerateMimeMultipartBoundary();
-  auto blob_builder_callback =
-      base::BindOnce(&BuildBlobWithFolder, folder_path.DirName(), mime_boundary,
-                     std::move(files));
-
-  std::string content_type = ipfs::kIPFSImportMultipartContentType;
-  content_type += " boundary=";
-  content_type += mime_boundary;
-
-  base::PostTaskAndReplyWithResult(
-      FROM_HERE, {base::MayBlock(), content::BrowserThread::IO},
-      base::BindOnce(&CreateResourceRequest, std::move(blob_builder_callback),
-                     content_type, blob_context_getter_factory),
-      std::move(request_callback));
-}
-
-void CreateRequestForFolder(const base::FilePath& folder_path,
-                            ipfs::BlobContextGetterFactory* context_factory,
-                            ResourceRequestGetter request_callback) {
-  base::ThreadPool::PostTaskAndReplyWithResult(
-      FROM_HERE, {base::MayBlock()},
-      base::BindOnce(&EnumerateDirectoryFiles, folder_path),
-      base::BindOnce(&CreateRequestForFileList, std::move(request_callback),
-                     context_factory, folder_path));
-}
-
 void CreateRequestForText(const std::string& text,
                           const std::string& filename,
                           ipfs::BlobContextGetterFactory* context_factory,
@@ -65,10 +65,6 @@ void CreateRequestForFile(const base::FilePath& upload_file_path,
                           ResourceRequestGetter request_callback,
                           size_t file_size);
 
-void CreateRequestForFolder(const base::FilePath& folder_path,
-                            BlobContextGetterFactory* context_getter_factory,
-                            ResourceRequestGetter request_callback);
-
 void CreateRequestForText(const std::string& text,
                           const std::string& filename,
                           BlobContextGetterFactory* blob_context_getter_factory,
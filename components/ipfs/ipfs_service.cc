@@ -21,6 +21,7 @@
 #include "base/task_runner_util.h"
 #include "brave/components/ipfs/blob_context_getter_factory.h"
 #include "brave/components/ipfs/buildflags/buildflags.h"
+#include "brave/components/ipfs/ipfs_cid_cache.h"
 #include "brave/components/ipfs/ipfs_constants.h"
 #include "brave/components/ipfs/ipfs_json_parser.h"
 #include "brave/components/ipfs/ipfs_network_utils.h"
@@ -156,10 +157,28 @@ void IpfsService::RegisterProfilePrefs(PrefRegistrySimple* registry) {
   registry->RegisterBooleanPref(kIPFSAutoRedirectDNSLink, false);
   registry->RegisterIntegerPref(kIPFSInfobarCount, 0);
   registry->RegisterIntegerPref(kIpfsStorageMax, 1);
+  registry->RegisterIntegerPref(kIPFSCidCacheMaxSizeMB,
+                                kDefaultCidCacheMaxSizeMB);
   registry->RegisterStringPref(kIPFSPublicGatewayAddress, kDefaultIPFSGateway);
   registry->RegisterFilePathPref(kIPFSBinaryPath, base::FilePath());
 }
 
+void IpfsService::InitCidCache(const base::FilePath& cache_dir) {
+  DCHECK(!cid_cache_);
+  cid_cache_ = std::make_unique<IpfsCidCache>(
+      cache_dir, int64_t{prefs_->GetInteger(kIPFSCidCacheMaxSizeMB)} << 20);
+  pref_change_registrar_.Init(prefs_);
+  pref_change_registrar_.Add(
+      kIPFSCidCacheMaxSizeMB,
+      base::BindRepeating(&IpfsService::OnCidCacheMaxSizeChanged,
+                          base::Unretained(this)));
+}
+
+void IpfsService::OnCidCacheMaxSizeChanged() {
+  cid_cache_->SetMaxSize(int64_t{prefs_->GetInteger(kIPFSCidCacheMaxSizeMB)}
+                         << 20);
+}
+
 base::FilePath IpfsService::GetIpfsExecutablePath() const {
   return prefs_->GetFilePath(kIPFSBinaryPath);
 }
@@ -16,6 +16,7 @@
 #include "base/containers/queue.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/observer_list.h"
+#include "components/prefs/pref_change_registrar.h"
 #include "brave/components/ipfs/addresses_config.h"
 #include "brave/components/ipfs/blob_context_getter_factory.h"
 #include "brave/components/ipfs/brave_ipfs_client_updater.h"
@@ -47,6 +48,7 @@ class PrefRegistrySimple;
 namespace ipfs {
 
 class BraveIpfsClientUpdater;
+class IpfsCidCache;
 class IpfsServiceDelegate;
 class IpfsServiceObserver;
 #if BUILDFLAG(ENABLE_IPFS_LOCAL_NODE)
@@ -104,6 +106,10 @@ class IpfsService : public KeyedService,
 
   virtual void PreWarmShareableLink(const GURL& url);
 
+  // Enables the cache of immutable /ipfs/ responses stored in |cache_dir|.
+  void InitCidCache(const base::FilePath& cache_dir);
+  IpfsCidCache* GetCidCache() { return cid_cache_.get(); }
+
 #if BUILDFLAG(ENABLE_IPFS_LOCAL_NODE)
   virtual void ImportFileToIpfs(const base::FilePath& path,
                                 const std::string& key,
@@ -204,6 +210,7 @@ class IpfsService : public KeyedService,
   void OnPreWarmComplete(SimpleURLLoaderList::iterator iter,
                          std::unique_ptr<std::string> response_body);
   std::string GetStorageSize();
+  void OnCidCacheMaxSizeChanged();
   // The remote to the ipfs service running on an utility process. The browser
   // will not launch a new ipfs service process if this remote is already
   // bound.
@@ -239,6 +246,8 @@ class IpfsService : public KeyedService,
 #endif
   scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
   IpfsP3A ipfs_p3a_;
+  std::unique_ptr<IpfsCidCache> cid_cache_;
+  PrefChangeRegistrar pref_change_registrar_;
   base::WeakPtrFactory<IpfsService> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(IpfsService);
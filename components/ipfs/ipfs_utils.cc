@@ -400,4 +400,33 @@ std::string GetRegistryDomainFromIPNS(const GURL& url) {
       cid, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
 }
 
+std::string GetImmutableIPFSCacheKey(const GURL& url) {
+  if (!url.SchemeIsHTTPOrHTTPS() || url.has_query())
+    return std::string();
+  std::string cid;
+  std::string path;
+  const std::string ipfs_prefix = std::string("/") + kIPFSScheme + "/";
+  if (base::StartsWith(url.path_piece(), ipfs_prefix)) {
+    // [scheme]://[gateway]/ipfs/[cid][/path]
+    std::string rest = url.path().substr(ipfs_prefix.size());
+    size_t pos = rest.find('/');
+    cid = rest.substr(0, pos);
+    if (pos != std::string::npos)
+      path = rest.substr(pos);
+  } else {
+    // [scheme]://[cid].ipfs.[gateway][/path]
+    std::vector<base::StringPiece> labels = base::SplitStringPiece(
+        url.host_piece(), ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+    if (labels.size() < 3 || labels[1] != kIPFSScheme)
+      return std::string();
+    cid = std::string(labels[0]);
+    path = url.path();
+  }
+  if (!IsValidCID(cid))
+    return std::string();
+  if (path.empty())
+    path = "/";
+  return cid + path;
+}
+
 }  // namespace ipfs
@@ -62,6 +62,11 @@ GURL ContentHashToCIDv1URL(const std::string& contenthash);
 bool IsAPIGateway(const GURL& url, version_info::Channel channel);
 bool IsIpfsResolveMethodDisabled(PrefService* prefs);
 std::string GetRegistryDomainFromIPNS(const GURL& url);
+// Returns "[cid][/path]" for immutable gateway URLs like
+// [scheme]://[gateway]/ipfs/[cid][/path] or
+// [scheme]://[cid].ipfs.[gateway][/path], otherwise an empty string.
+// /ipns/ URLs and URLs with a query are mutable and never get a key.
+std::string GetImmutableIPFSCacheKey(const GURL& url);
 }  // namespace ipfs
 
 #endif  // BRAVE_COMPONENTS_IPFS_IPFS_UTILS_H_
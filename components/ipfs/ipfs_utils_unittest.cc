@@ -672,3 +672,36 @@ TEST_F(IpfsUtilsUnitTest, IPNSRegistryDomain) {
   EXPECT_EQ(ipfs::GetRegistryDomainFromIPNS(GURL("ipns://blah.google.com")),
             "google.com");
 }
+
+TEST_F(IpfsUtilsUnitTest, GetImmutableIPFSCacheKey) {
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(
+                GURL("https://dweb.link/ipfs/QmYbK4/wiki/index.html")),
+            "QmYbK4/wiki/index.html");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(
+                GURL("http://localhost:48080/ipfs/bafybeih")),
+            "bafybeih/");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(
+                GURL("https://bafybeih.ipfs.dweb.link/wiki/index.html")),
+            "bafybeih/wiki/index.html");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(
+                GURL("http://bafybeih.ipfs.localhost:48080/")),
+            "bafybeih/");
+  // Mutable or unsupported resources.
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(
+                GURL("https://dweb.link/ipns/brave.eth/index.html")),
+            "");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(
+                GURL("https://brave.eth.ipns.dweb.link/index.html")),
+            "");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(
+                GURL("https://dweb.link/ipfs/QmYbK4/index.html?download=1")),
+            "");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(GURL("ipfs://QmYbK4/index.html")),
+            "");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(GURL("https://dweb.link/ipfs/")),
+            "");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(GURL("https://brave.com/")), "");
+  EXPECT_EQ(ipfs::GetImmutableIPFSCacheKey(
+                GURL("https://dweb.link/ipfs/Qm..%2F/index.html")),
+            "");
+}
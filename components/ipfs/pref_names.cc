@@ -33,6 +33,10 @@ const char kIPFSInfobarCount[] = "brave.ipfs.infobar_count";
 // The number of storage used by IPFS Node
 const char kIpfsStorageMax[] = "brave.ipfs.storage_max";
 
+// The disk budget in megabytes for immutable /ipfs/ responses cached by the
+// browser.
+const char kIPFSCidCacheMaxSizeMB[] = "brave.ipfs.cid_cache_max_size_mb";
+
 // Used to enable/disable IPFS via admin policy.
 const char kIPFSEnabled[] = "brave.ipfs.enabled";
 
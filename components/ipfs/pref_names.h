@@ -15,5 +15,6 @@ extern const char kIPFSInfobarCount[];
 extern const char kIPFSEnabled[];
 extern const char kIPFSPublicGatewayAddress[];
 extern const char kIpfsStorageMax[];
+extern const char kIPFSCidCacheMaxSizeMB[];
 
 #endif  // BRAVE_COMPONENTS_IPFS_PREF_NAMES_H_
@@ -36,15 +36,22 @@ bool IsSuperReferralPath(const std::string& path) {
   return path.rfind(kSuperReferralPath, 0) == 0;
 }
 
+// A campaign has a handful of wallpapers of a few megabytes each.
+constexpr size_t kMaxImageCacheBytes = 32 * 1024 * 1024;
+
 }  // namespace
 
 NTPBackgroundImagesSource::NTPBackgroundImagesSource(
     NTPBackgroundImagesService* service)
     : service_(service),
+      image_cache_(ImageCache::NO_AUTO_EVICT),
       weak_factory_(this) {
+  service_->AddObserver(this);
 }
 
-NTPBackgroundImagesSource::~NTPBackgroundImagesSource() = default;
+NTPBackgroundImagesSource::~NTPBackgroundImagesSource() {
+  service_->RemoveObserver(this);
+}
 
 std::string NTPBackgroundImagesSource::GetSource() {
   return kBrandedWallpaperHost;
@@ -89,33 +96,129 @@ void NTPBackgroundImagesSource::StartDataRequest(
     }
   } else {
     DCHECK(IsWallpaperPath(path));
-    image_file_path =
-        images_data->backgrounds[GetWallpaperIndexFromPath(path)].image_file;
+    const int wallpaper_index = GetWallpaperIndexFromPath(path);
+    image_file_path = images_data->backgrounds[wallpaper_index].image_file;
+    GetImageFile(image_file_path, std::move(callback));
+    PrefetchNextWallpaper(*images_data, wallpaper_index);
+    return;
   }
 
   GetImageFile(image_file_path, std::move(callback));
 }
 
+#if BUILDFLAG(ENABLE_NTP_BACKGROUND_IMAGES)
+void NTPBackgroundImagesSource::OnUpdated(NTPBackgroundImagesData* data) {
+  // Background images are not served by this source.
+}
+#endif
+
+void NTPBackgroundImagesSource::OnUpdated(NTPSponsoredImagesData* data) {
+  ClearImageCache();
+}
+
+void NTPBackgroundImagesSource::OnSuperReferralEnded() {
+  ClearImageCache();
+}
+
 void NTPBackgroundImagesSource::GetImageFile(
     const base::FilePath& image_file_path,
     GotDataCallback callback) {
+  auto cached = image_cache_.Get(image_file_path);
+  if (cached != image_cache_.end()) {
+    std::move(callback).Run(cached->second);
+    return;
+  }
+
+  auto& callbacks = pending_reads_[image_file_path];
+  callbacks.push_back(std::move(callback));
+  if (callbacks.size() == 1)
+    ReadImageFile(image_file_path);
+}
+
+void NTPBackgroundImagesSource::PrefetchImageFile(
+    const base::FilePath& image_file_path) {
+  if (image_file_path.empty() ||
+      image_cache_.Peek(image_file_path) != image_cache_.end() ||
+      pending_reads_.count(image_file_path)) {
+    return;
+  }
+
+  pending_reads_[image_file_path];
+  ReadImageFile(image_file_path);
+}
+
+void NTPBackgroundImagesSource::PrefetchNextWallpaper(
+    const NTPSponsoredImagesData& images_data,
+    int wallpaper_index) {
+  // ViewCounterModel rotates through the campaign in order, so the next
+  // branded new tab page shows the following wallpaper.
+  const int wallpaper_count = images_data.backgrounds.size();
+  if (wallpaper_count < 2)
+    return;
+
+  const auto& next =
+      images_data.backgrounds[(wallpaper_index + 1) % wallpaper_count];
+  PrefetchImageFile(next.image_file);
+  if (next.logo)
+    PrefetchImageFile(next.logo->image_file);
+}
+
+void NTPBackgroundImagesSource::ReadImageFile(
+    const base::FilePath& image_file_path) {
   base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE, {base::MayBlock()},
       base::BindOnce(&ReadFileToString, image_file_path),
       base::BindOnce(&NTPBackgroundImagesSource::OnGotImageFile,
-                     weak_factory_.GetWeakPtr(), std::move(callback)));
+                     weak_factory_.GetWeakPtr(), image_file_path,
+                     image_cache_generation_));
 }
 
 void NTPBackgroundImagesSource::OnGotImageFile(
-    GotDataCallback callback,
+    const base::FilePath& image_file_path,
+    int cache_generation,
     absl::optional<std::string> input) {
-  if (!input)
-    return;
+  std::vector<GotDataCallback> callbacks;
+  auto pending = pending_reads_.find(image_file_path);
+  if (pending != pending_reads_.end()) {
+    callbacks = std::move(pending->second);
+    pending_reads_.erase(pending);
+  }
 
   scoped_refptr<base::RefCountedMemory> bytes;
-  bytes = new base::RefCountedBytes(
-       reinterpret_cast<const unsigned char*>(input->c_str()), input->length());
-  std::move(callback).Run(std::move(bytes));
+  if (input) {
+    bytes = base::RefCountedString::TakeString(&*input);
+    if (cache_generation == image_cache_generation_)
+      CacheImage(image_file_path, bytes);
+  }
+
+  for (auto& callback : callbacks)
+    std::move(callback).Run(bytes);
+}
+
+void NTPBackgroundImagesSource::CacheImage(
+    const base::FilePath& image_file_path,
+    scoped_refptr<base::RefCountedMemory> bytes) {
+  if (bytes->size() > kMaxImageCacheBytes)
+    return;
+
+  auto existing = image_cache_.Peek(image_file_path);
+  if (existing != image_cache_.end())
+    image_cache_bytes_ -= existing->second->size();
+
+  image_cache_bytes_ += bytes->size();
+  image_cache_.Put(image_file_path, std::move(bytes));
+
+  while (image_cache_bytes_ > kMaxImageCacheBytes) {
+    auto oldest = image_cache_.rbegin();
+    image_cache_bytes_ -= oldest->second->size();
+    image_cache_.Erase(oldest);
+  }
+}
+
+void NTPBackgroundImagesSource::ClearImageCache() {
+  image_cache_.Clear();
+  image_cache_bytes_ = 0;
+  image_cache_generation_++;
 }
 
 std::string NTPBackgroundImagesSource::GetMimeType(const std::string& path) {
@@ -6,22 +6,27 @@
 #ifndef BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_BACKGROUND_IMAGES_SOURCE_H_
 #define BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_BACKGROUND_IMAGES_SOURCE_H_
 
+#include <map>
 #include <string>
+#include <vector>
 
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
+#include "brave/components/ntp_background_images/browser/ntp_background_images_service.h"
+#include "brave/components/ntp_background_images/buildflags/buildflags.h"
 #include "content/public/browser/url_data_source.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
-namespace base {
-class FilePath;
-}  // namespace base
-
 namespace ntp_background_images {
 
-class NTPBackgroundImagesService;
-
-// This serves background image data.
-class NTPBackgroundImagesSource : public content::URLDataSource {
+// This serves background image data. Image bytes of the current campaign are
+// kept in a bounded in-memory cache so that repeated new tab page opens don't
+// hit the disk, and the wallpaper shown after the requested one is read ahead.
+// The cache is dropped whenever the service reports new component data.
+class NTPBackgroundImagesSource : public content::URLDataSource,
+                                  public NTPBackgroundImagesService::Observer {
  public:
   explicit NTPBackgroundImagesSource(NTPBackgroundImagesService* service);
 
@@ -35,6 +40,14 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest, BasicTest);
   FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest,
                            BasicSuperReferralDataTest);
+  FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest, ImageFileIsCached);
+  FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest,
+                           CacheIsClearedOnComponentUpdate);
+  FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest,
+                           NextWallpaperIsPrefetched);
+
+  using ImageCache =
+      base::MRUCache<base::FilePath, scoped_refptr<base::RefCountedMemory>>;
 
   // content::URLDataSource overrides:
   std::string GetSource() override;
@@ -44,10 +57,25 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   std::string GetMimeType(const std::string& path) override;
   bool AllowCaching() override;
 
+  // NTPBackgroundImagesService::Observer overrides:
+#if BUILDFLAG(ENABLE_NTP_BACKGROUND_IMAGES)
+  void OnUpdated(NTPBackgroundImagesData* data) override;
+#endif
+  void OnUpdated(NTPSponsoredImagesData* data) override;
+  void OnSuperReferralEnded() override;
+
   void GetImageFile(const base::FilePath& image_file_path,
                     GotDataCallback callback);
-  void OnGotImageFile(GotDataCallback callback,
+  void PrefetchImageFile(const base::FilePath& image_file_path);
+  void PrefetchNextWallpaper(const NTPSponsoredImagesData& images_data,
+                             int wallpaper_index);
+  void ReadImageFile(const base::FilePath& image_file_path);
+  void OnGotImageFile(const base::FilePath& image_file_path,
+                      int cache_generation,
                       absl::optional<std::string> input);
+  void CacheImage(const base::FilePath& image_file_path,
+                  scoped_refptr<base::RefCountedMemory> bytes);
+  void ClearImageCache();
   bool IsValidPath(const std::string& path) const;
   bool IsLogoPath(const std::string& path) const;
   bool IsDefaultLogoPath(const std::string& path) const;
@@ -58,6 +86,15 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   base::FilePath GetTopSiteFaviconFilePath(const std::string& path) const;
 
   NTPBackgroundImagesService* service_;  // not owned
+
+  ImageCache image_cache_;
+  size_t image_cache_bytes_ = 0;
+  // Bumped whenever the cache is cleared so that reads started against the
+  // previous component data are not cached.
+  int image_cache_generation_ = 0;
+  // Callbacks waiting for an in-flight read. A prefetch has no callbacks.
+  std::map<base::FilePath, std::vector<GotDataCallback>> pending_reads_;
+
   base::WeakPtrFactory<NTPBackgroundImagesSource> weak_factory_;
 };
 
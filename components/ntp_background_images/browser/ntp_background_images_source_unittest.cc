@@ -6,15 +6,21 @@
 #include <memory>
 #include <string>
 
-#include "base/test/task_environment.h"
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/ref_counted_memory.h"
 #include "brave/components/brave_referrals/browser/brave_referrals_service.h"
 #include "brave/components/brave_referrals/buildflags/buildflags.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_service.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_source.h"
 #include "brave/components/ntp_background_images/browser/ntp_sponsored_images_data.h"
+#include "brave/components/ntp_background_images/browser/url_constants.h"
 #include "brave/components/ntp_background_images/common/pref_names.h"
 #include "components/prefs/testing_pref_service.h"
+#include "content/public/test/browser_task_environment.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
 
 namespace ntp_background_images {
 
@@ -32,7 +38,27 @@ class NTPBackgroundImagesSourceTest : public testing::Test {
                     base::Value(base::Value::Type::DICTIONARY));
   }
 
-  base::test::SingleThreadTaskEnvironment task_environment;
+  // Reads |image_file_path| through the source and returns what it served.
+  scoped_refptr<base::RefCountedMemory> GetImageFile(
+      const base::FilePath& image_file_path) {
+    scoped_refptr<base::RefCountedMemory> result;
+    source_->GetImageFile(
+        image_file_path,
+        base::BindOnce(
+            [](scoped_refptr<base::RefCountedMemory>* result,
+               scoped_refptr<base::RefCountedMemory> bytes) {
+              *result = std::move(bytes);
+            },
+            &result));
+    task_environment.RunUntilIdle();
+    return result;
+  }
+
+  std::string ToString(scoped_refptr<base::RefCountedMemory> bytes) {
+    return std::string(bytes->front_as<char>(), bytes->size());
+  }
+
+  content::BrowserTaskEnvironment task_environment;
   TestingPrefServiceSimple local_pref_;
   std::unique_ptr<NTPBackgroundImagesService> service_;
   std::unique_ptr<NTPBackgroundImagesSource> source_;
@@ -78,6 +104,86 @@ TEST_F(NTPBackgroundImagesSourceTest, BasicTest) {
       source_->GetWallpaperIndexFromPath("sponsored-images/wallpaper-3.jpg"));
 }
 
+TEST_F(NTPBackgroundImagesSourceTest, ImageFileIsCached) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath image = temp_dir.GetPath().AppendASCII("image.jpg");
+  ASSERT_TRUE(base::WriteFile(image, "image data"));
+
+  auto bytes = GetImageFile(image);
+  ASSERT_TRUE(bytes);
+  EXPECT_EQ("image data", ToString(bytes));
+
+  // Served from memory once read.
+  ASSERT_TRUE(base::DeleteFile(image));
+  auto cached_bytes = GetImageFile(image);
+  ASSERT_TRUE(cached_bytes);
+  EXPECT_EQ("image data", ToString(cached_bytes));
+
+  EXPECT_FALSE(GetImageFile(temp_dir.GetPath().AppendASCII("missing.jpg")));
+}
+
+TEST_F(NTPBackgroundImagesSourceTest, CacheIsClearedOnComponentUpdate) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath image = temp_dir.GetPath().AppendASCII("image.jpg");
+  ASSERT_TRUE(base::WriteFile(image, "image data"));
+
+  ASSERT_TRUE(GetImageFile(image));
+  ASSERT_TRUE(base::DeleteFile(image));
+
+  service_->OnGetSponsoredComponentJsonData(false, "{}");
+  EXPECT_FALSE(GetImageFile(image));
+}
+
+TEST_F(NTPBackgroundImagesSourceTest, NextWallpaperIsPrefetched) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath dir = temp_dir.GetPath();
+  for (const char* name : {"background-1.jpg", "background-2.jpg",
+                           "background-3.jpg"}) {
+    ASSERT_TRUE(base::WriteFile(dir.AppendASCII(name), name));
+  }
+
+  const std::string test_json_string = R"(
+      {
+        "schemaVersion": 1,
+        "logo": {
+          "imageUrl": "logo.png",
+          "alt": "Technikke: For music lovers",
+          "companyName": "Technikke",
+          "destinationUrl": "https://www.brave.com/?from-super-referreer-demo"
+        },
+        "wallpapers": [
+          { "imageUrl": "background-1.jpg" },
+          { "imageUrl": "background-2.jpg" },
+          { "imageUrl": "background-3.jpg" }
+        ]
+      })";
+  service_->si_installed_dir_ = dir;
+  service_->OnGetSponsoredComponentJsonData(false, test_json_string);
+
+  scoped_refptr<base::RefCountedMemory> result;
+  source_->StartDataRequest(
+      GURL(std::string("chrome://") + kBrandedWallpaperHost + "/" +
+           kSponsoredImagesPath + "wallpaper-0.jpg"),
+      content::WebContents::Getter(),
+      base::BindOnce(
+          [](scoped_refptr<base::RefCountedMemory>* result,
+             scoped_refptr<base::RefCountedMemory> bytes) {
+            *result = std::move(bytes);
+          },
+          &result));
+  task_environment.RunUntilIdle();
+  ASSERT_TRUE(result);
+  EXPECT_EQ("background-1.jpg", ToString(result));
+
+  const auto& cache = source_->image_cache_;
+  EXPECT_NE(cache.end(), cache.Peek(dir.AppendASCII("background-1.jpg")));
+  EXPECT_NE(cache.end(), cache.Peek(dir.AppendASCII("background-2.jpg")));
+  EXPECT_EQ(cache.end(), cache.Peek(dir.AppendASCII("background-3.jpg")));
+}
+
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
 
 #if !defined(OS_LINUX)
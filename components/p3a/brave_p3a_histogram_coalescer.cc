@@ -0,0 +1,55 @@
+/* Copyright 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_histogram_coalescer.h"
+
+#include <limits>
+
+#include "base/check_op.h"
+
+namespace brave {
+
+namespace {
+
+// Marks a histogram without changes since the last take.
+constexpr uint64_t kNoBucket = std::numeric_limits<uint64_t>::max();
+
+}  // namespace
+
+BraveP3AHistogramCoalescer::BraveP3AHistogramCoalescer(size_t histogram_count)
+    : histogram_count_(histogram_count),
+      buckets_(new std::atomic<uint64_t>[histogram_count]) {
+  for (size_t i = 0; i < histogram_count_; i++) {
+    buckets_[i].store(kNoBucket, std::memory_order_relaxed);
+  }
+}
+
+BraveP3AHistogramCoalescer::~BraveP3AHistogramCoalescer() = default;
+
+bool BraveP3AHistogramCoalescer::Update(size_t histogram_index,
+                                        uint64_t bucket) {
+  DCHECK_LT(histogram_index, histogram_count_);
+  DCHECK_NE(bucket, kNoBucket);
+  buckets_[histogram_index].store(bucket, std::memory_order_release);
+  // The bucket is stored first, so a take that clears the flag after this
+  // point either sees the bucket or is followed by another take.
+  return !take_scheduled_.exchange(true, std::memory_order_acq_rel);
+}
+
+BraveP3AHistogramCoalescer::Changes BraveP3AHistogramCoalescer::TakeChanges() {
+  take_scheduled_.store(false, std::memory_order_release);
+
+  Changes changes;
+  for (size_t i = 0; i < histogram_count_; i++) {
+    const uint64_t bucket =
+        buckets_[i].exchange(kNoBucket, std::memory_order_acq_rel);
+    if (bucket != kNoBucket) {
+      changes.emplace_back(i, bucket);
+    }
+  }
+  return changes;
+}
+
+}  // namespace brave
@@ -0,0 +1,49 @@
+/* Copyright 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_P3A_BRAVE_P3A_HISTOGRAM_COALESCER_H_
+#define BRAVE_COMPONENTS_P3A_BRAVE_P3A_HISTOGRAM_COALESCER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace brave {
+
+// Keeps the latest bucket of each collected histogram. Buckets are written
+// from any thread without locking and taken in batches on the UI thread, so
+// frequently recorded histograms cost one task per batch instead of one task
+// per sample.
+class BraveP3AHistogramCoalescer {
+ public:
+  // Pairs of histogram index and its latest bucket.
+  using Changes = std::vector<std::pair<size_t, uint64_t>>;
+
+  explicit BraveP3AHistogramCoalescer(size_t histogram_count);
+  ~BraveP3AHistogramCoalescer();
+
+  BraveP3AHistogramCoalescer(const BraveP3AHistogramCoalescer&) = delete;
+  BraveP3AHistogramCoalescer& operator=(const BraveP3AHistogramCoalescer&) =
+      delete;
+
+  // May be called on any thread. Returns true if this is the first change
+  // since the last |TakeChanges()|, the caller should then schedule a call to
+  // it.
+  bool Update(size_t histogram_index, uint64_t bucket);
+
+  // Returns the buckets updated since the last call, ordered by index.
+  Changes TakeChanges();
+
+ private:
+  const size_t histogram_count_;
+  std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+  std::atomic<bool> take_scheduled_{false};
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMPONENTS_P3A_BRAVE_P3A_HISTOGRAM_COALESCER_H_
@@ -0,0 +1,82 @@
+/* Copyright 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_histogram_coalescer.h"
+
+#include <atomic>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/task/thread_pool.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3AHistogramCoalescerTest.*
+
+namespace brave {
+
+namespace {
+
+constexpr size_t kHistogramCount = 4;
+constexpr int kSamplesPerThread = 250000;
+
+}  // namespace
+
+class BraveP3AHistogramCoalescerTest : public testing::Test {
+ protected:
+  BraveP3AHistogramCoalescerTest() : coalescer_(kHistogramCount) {}
+
+  base::test::TaskEnvironment task_environment_;
+  BraveP3AHistogramCoalescer coalescer_;
+};
+
+TEST_F(BraveP3AHistogramCoalescerTest, KeepsLatestBucket) {
+  // Only the first update since the last take asks for a new one.
+  EXPECT_TRUE(coalescer_.Update(0, 1));
+  EXPECT_FALSE(coalescer_.Update(0, 2));
+  EXPECT_FALSE(coalescer_.Update(2, 5));
+
+  const BraveP3AHistogramCoalescer::Changes changes = coalescer_.TakeChanges();
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0], std::make_pair(size_t{0}, uint64_t{2}));
+  EXPECT_EQ(changes[1], std::make_pair(size_t{2}, uint64_t{5}));
+  EXPECT_TRUE(coalescer_.TakeChanges().empty());
+
+  // The next change schedules a new take.
+  EXPECT_TRUE(coalescer_.Update(1, 3));
+}
+
+TEST_F(BraveP3AHistogramCoalescerTest, UpdatesFromManyThreads) {
+  std::atomic<int> scheduled_takes{0};
+
+  for (size_t i = 0; i < kHistogramCount; i++) {
+    base::ThreadPool::PostTask(
+        FROM_HERE, base::BindOnce(
+                       [](BraveP3AHistogramCoalescer* coalescer,
+                          std::atomic<int>* scheduled_takes, size_t index) {
+                         for (int j = 0; j < kSamplesPerThread; j++) {
+                           const uint64_t bucket =
+                               j == kSamplesPerThread - 1 ? index : j % 8;
+                           if (coalescer->Update(index, bucket)) {
+                             (*scheduled_takes)++;
+                           }
+                         }
+                       },
+                       &coalescer_, &scheduled_takes, i));
+  }
+  task_environment_.RunUntilIdle();
+
+  // Nothing was taken in between, so only the first update schedules.
+  EXPECT_EQ(scheduled_takes.load(), 1);
+
+  const BraveP3AHistogramCoalescer::Changes changes = coalescer_.TakeChanges();
+  ASSERT_EQ(changes.size(), kHistogramCount);
+  for (size_t i = 0; i < kHistogramCount; i++) {
+    EXPECT_EQ(changes[i].first, i);
+    EXPECT_EQ(changes[i].second, i);
+  }
+}
+
+}  // namespace brave
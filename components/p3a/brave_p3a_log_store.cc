@@ -51,18 +51,30 @@ void BraveP3ALogStore::RegisterPrefs(PrefRegistrySimple* registry) {
 
 void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
                                    uint64_t value) {
-  LogEntry& entry = log_[histogram_name];
-  entry.value = value;
-  if (!entry.sent) {
-    DCHECK(entry.sent_timestamp.is_null());
-    unsent_entries_.insert(histogram_name);
+  UpdateValues({{histogram_name, value}});
+}
+
+void BraveP3ALogStore::UpdateValues(
+    const base::flat_map<std::string, uint64_t>& values) {
+  if (values.empty()) {
+    return;
   }
 
-  // Update the persistent value.
   DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({histogram_name, kLogValueKey},
-                  base::Value(base::NumberToString(value)));
-  update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  for (const auto& value : values) {
+    const std::string& histogram_name = value.first;
+    LogEntry& entry = log_[histogram_name];
+    entry.value = value.second;
+    if (!entry.sent) {
+      DCHECK(entry.sent_timestamp.is_null());
+      unsent_entries_.insert(histogram_name);
+    }
+
+    // Update the persistent value.
+    update->SetPath({histogram_name, kLogValueKey},
+                    base::Value(base::NumberToString(value.second)));
+    update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  }
 }
 
 void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
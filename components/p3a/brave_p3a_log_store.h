@@ -45,6 +45,8 @@ class BraveP3ALogStore : public metrics::LogStore {
   static void RegisterPrefs(PrefRegistrySimple* registry);
 
   void UpdateValue(const std::string& histogram_name, uint64_t value);
+  // Same as |UpdateValue()| for each entry, with a single pref update.
+  void UpdateValues(const base::flat_map<std::string, uint64_t>& values);
   // Removes and also unstages the metric value if it is known and/or staged.
   void RemoveValueIfExists(const std::string& histogram_name);
   // Marks all saved values as unsent.
@@ -10,6 +10,7 @@
 #include <utility>
 
 #include "base/command_line.h"
+#include "base/cxx17_backports.h"
 #include "base/i18n/timezone.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/histogram_samples.h"
@@ -55,6 +56,10 @@ constexpr char kP2AServerUrl[] = "https://p2a.brave.com/";
 
 constexpr uint64_t kDefaultUploadIntervalSeconds = 60;  // 1 minute.
 
+// Histogram changes are handed to the log at most this often.
+constexpr base::TimeDelta kHistogramFlushDelay =
+    base::TimeDelta::FromSeconds(1);
+
 // TODO(iefremov): Provide moar histograms!
 // Whitelist for histograms that we collect. Will be replaced with something
 // updating on the fly.
@@ -202,7 +207,8 @@ BraveP3AService::BraveP3AService(PrefService* local_state,
                                  std::string week_of_install)
     : local_state_(std::move(local_state)),
       channel_(std::move(channel)),
-      week_of_install_(week_of_install) {}
+      week_of_install_(week_of_install),
+      histogram_coalescer_(base::size(kCollectedHistograms)) {}
 
 BraveP3AService::~BraveP3AService() = default;
 
@@ -217,12 +223,13 @@ void BraveP3AService::RegisterPrefs(PrefRegistrySimple* registry,
 }
 
 void BraveP3AService::InitCallbacks() {
-  for (const char* histogram_name : kCollectedHistograms) {
+  for (size_t i = 0; i < base::size(kCollectedHistograms); i++) {
     histogram_sample_callbacks_.push_back(
         std::make_unique<
             base::StatisticsRecorder::ScopedHistogramSampleObserver>(
-            histogram_name,
-            base::BindRepeating(&BraveP3AService::OnHistogramChanged, this)));
+            kCollectedHistograms[i],
+            base::BindRepeating(&BraveP3AService::OnHistogramChanged, this,
+                                i)));
   }
 }
 
@@ -250,9 +257,7 @@ void BraveP3AService::Init(
   log_store_.reset(new BraveP3ALogStore(this, local_state_));
   log_store_->LoadPersistedUnsentLogs();
   // Store values that were recorded between calling constructor and |Init()|.
-  for (const auto& entry : histogram_values_) {
-    HandleHistogramChange(std::string(entry.first), entry.second);
-  }
+  HandleHistogramChanges(histogram_values_);
   histogram_values_ = {};
   // Do rotation if needed.
   const base::Time last_rotation =
@@ -407,7 +412,8 @@ void BraveP3AService::StartScheduledUpload() {
   }
 }
 
-void BraveP3AService::OnHistogramChanged(const char* histogram_name,
+void BraveP3AService::OnHistogramChanged(size_t histogram_index,
+                                         const char* histogram_name,
                                          uint64_t name_hash,
                                          base::HistogramBase::Sample sample) {
   std::unique_ptr<base::HistogramSamples> samples =
@@ -420,12 +426,7 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
   // Shortcut for the special values, see |kSuspendedMetricValue|
   // description for details.
   if (IsSuspendedMetric(histogram_name, sample)) {
-    base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                   base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI,
-                                  this,
-                                  histogram_name,
-                                  kSuspendedMetricValue,
-                                  kSuspendedMetricBucket));
+    SetHistogramBucket(histogram_index, kSuspendedMetricBucket);
     return;
   }
 
@@ -454,31 +455,47 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
     bucket = DirectEncodingProtocol::Perturb(bucket_count, bucket);
   }
 
-  base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                 base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI, this,
-                                histogram_name, sample, bucket));
+  SetHistogramBucket(histogram_index, bucket);
 }
 
-void BraveP3AService::OnHistogramChangedOnUI(const char* histogram_name,
-                                             base::HistogramBase::Sample sample,
-                                             size_t bucket) {
-  VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
-          << histogram_name << " Sample = " << sample << " bucket = " << bucket;
+void BraveP3AService::SetHistogramBucket(size_t histogram_index,
+                                         size_t bucket) {
+  if (histogram_coalescer_.Update(histogram_index, bucket)) {
+    base::PostDelayedTask(
+        FROM_HERE, {content::BrowserThread::UI},
+        base::BindOnce(&BraveP3AService::FlushHistogramChanges, this),
+        kHistogramFlushDelay);
+  }
+}
+
+void BraveP3AService::FlushHistogramChanges() {
+  for (const auto& change : histogram_coalescer_.TakeChanges()) {
+    const char* histogram_name = kCollectedHistograms[change.first];
+    VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
+            << histogram_name << " bucket = " << change.second;
+    histogram_values_[histogram_name] = change.second;
+  }
+
   if (!initialized_) {
     // Will handle it later when ready.
-    histogram_values_[histogram_name] = bucket;
-  } else {
-    HandleHistogramChange(histogram_name, bucket);
+    return;
   }
+
+  HandleHistogramChanges(histogram_values_);
+  histogram_values_ = {};
 }
 
-void BraveP3AService::HandleHistogramChange(base::StringPiece histogram_name,
-                                            size_t bucket) {
-  if (IsSuspendedMetric(histogram_name, bucket)) {
-    log_store_->RemoveValueIfExists(std::string(histogram_name));
-    return;
+void BraveP3AService::HandleHistogramChanges(
+    const base::flat_map<base::StringPiece, size_t>& buckets) {
+  base::flat_map<std::string, uint64_t> values;
+  for (const auto& entry : buckets) {
+    if (IsSuspendedMetric(entry.first, entry.second)) {
+      log_store_->RemoveValueIfExists(std::string(entry.first));
+      continue;
+    }
+    values[std::string(entry.first)] = entry.second;
   }
-  log_store_->UpdateValue(std::string(histogram_name), bucket);
+  log_store_->UpdateValues(values);
 }
 
 void BraveP3AService::OnLogUploadComplete(int response_code,
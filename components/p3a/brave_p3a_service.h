@@ -16,6 +16,7 @@
 #include "base/metrics/statistics_recorder.h"
 #include "base/timer/timer.h"
 #include "brave/components/brave_prochlo/brave_prochlo_message.h"
+#include "brave/components/p3a/brave_p3a_histogram_coalescer.h"
 #include "brave/components/p3a/brave_p3a_log_store.h"
 #include "url/gurl.h"
 
@@ -60,6 +61,7 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
 
  private:
   friend class base::RefCountedThreadSafe<BraveP3AService>;
+  friend class BraveP3AServiceTest;
   ~BraveP3AService() override;
 
   void MaybeOverrideSettingsFromCommandLine();
@@ -72,17 +74,21 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   void StartScheduledUpload();
 
   // Invoked by callbacks registered by our service. Since these callbacks
-  // can fire on any thread, this method reposts everything to UI thread.
-  void OnHistogramChanged(const char* histogram_name,
+  // can fire on any thread, this method only stores the latest bucket of
+  // |histogram_index| and schedules a flush on UI thread.
+  void OnHistogramChanged(size_t histogram_index,
+                          const char* histogram_name,
                           uint64_t name_hash,
                           base::HistogramBase::Sample sample);
 
-  void OnHistogramChangedOnUI(const char* histogram_name,
-                              base::HistogramBase::Sample sample,
-                              size_t bucket);
+  void SetHistogramBucket(size_t histogram_index, size_t bucket);
 
-  // Updates or removes a metric from the log.
-  void HandleHistogramChange(base::StringPiece histogram_name, size_t bucket);
+  // Hands the buckets stored since the last flush to the log.
+  void FlushHistogramChanges();
+
+  // Updates or removes metrics from the log.
+  void HandleHistogramChanges(
+      const base::flat_map<base::StringPiece, size_t>& buckets);
 
   void OnLogUploadComplete(int response_code, int error_code, bool was_https);
 
@@ -116,6 +122,9 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   // the service and its initialization.
   base::flat_map<base::StringPiece, size_t> histogram_values_;
 
+  // Latest buckets of the collected histograms, not yet flushed.
+  BraveP3AHistogramCoalescer histogram_coalescer_;
+
   // Once fired we restart the overall uploading process.
   base::OneShotTimer rotation_timer_;
 
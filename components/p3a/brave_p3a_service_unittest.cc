@@ -0,0 +1,130 @@
+/* Copyright 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_service.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/cxx17_backports.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "brave/components/brave_referrals/common/pref_names.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/testing_pref_service.h"
+#include "content/public/test/browser_task_environment.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3AServiceTest.*
+
+namespace brave {
+
+namespace {
+
+// The first entries of the collected histograms list.
+constexpr const char* kHistograms[] = {
+    "Brave.Core.BookmarksCountOnProfileLoad.2",
+    "Brave.Core.CrashReportsEnabled", "Brave.Core.IsDefault",
+    "Brave.Core.LastTimeIncognitoUsed"};
+constexpr size_t kHistogramCount = base::size(kHistograms);
+// Same as the service's flush delay.
+constexpr base::TimeDelta kFlushDelay = base::TimeDelta::FromSeconds(1);
+
+}  // namespace
+
+class BraveP3AServiceTest : public testing::Test {
+ protected:
+  BraveP3AServiceTest()
+      : task_environment_(base::test::TaskEnvironment::TimeSource::MOCK_TIME),
+        shared_url_loader_factory_(
+            base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+                &url_loader_factory_)) {}
+
+  void SetUp() override {
+    BraveP3AService::RegisterPrefs(local_state_.registry(),
+                                   /* first_run = */ false);
+    local_state_.registry()->RegisterStringPref(kReferralPromoCode,
+                                                std::string());
+    service_ = base::MakeRefCounted<BraveP3AService>(&local_state_, "release",
+                                                     "2021-01-04");
+    service_->Init(shared_url_loader_factory_);
+
+    registrar_.Init(&local_state_);
+    registrar_.Add("p3a.logs",
+                   base::BindRepeating(
+                       [](int* pref_writes) { (*pref_writes)++; },
+                       &pref_writes_));
+  }
+
+  void SetHistogramBucket(size_t histogram_index, size_t bucket) {
+    service_->SetHistogramBucket(histogram_index, bucket);
+  }
+
+  std::string GetStoredValue(const std::string& histogram_name) {
+    const base::Value* entry =
+        local_state_.GetDictionary("p3a.logs")->FindKey(histogram_name);
+    if (!entry) {
+      return "";
+    }
+    const std::string* value = entry->FindStringKey("value");
+    return value ? *value : "";
+  }
+
+  content::BrowserTaskEnvironment task_environment_;
+  network::TestURLLoaderFactory url_loader_factory_;
+  scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory_;
+  TestingPrefServiceSimple local_state_;
+  PrefChangeRegistrar registrar_;
+  scoped_refptr<BraveP3AService> service_;
+  int pref_writes_ = 0;
+};
+
+TEST_F(BraveP3AServiceTest, FlushesLatestBuckets) {
+  SetHistogramBucket(0, 1);
+  SetHistogramBucket(0, 2);
+  SetHistogramBucket(2, 5);
+
+  // Nothing reaches the log before the flush delay.
+  task_environment_.FastForwardBy(kFlushDelay / 2);
+  EXPECT_EQ(pref_writes_, 0);
+  EXPECT_EQ(GetStoredValue(kHistograms[0]), "");
+
+  task_environment_.FastForwardBy(kFlushDelay / 2);
+  EXPECT_EQ(pref_writes_, 1);
+  EXPECT_EQ(GetStoredValue(kHistograms[0]), "2");
+  EXPECT_EQ(GetStoredValue(kHistograms[1]), "");
+  EXPECT_EQ(GetStoredValue(kHistograms[2]), "5");
+}
+
+TEST_F(BraveP3AServiceTest, MillionSamplesBoundedFlushes) {
+  constexpr int kSamples = 1000000;
+  constexpr int kSamplesPerTick = 1000;
+  constexpr base::TimeDelta kTick = base::TimeDelta::FromMilliseconds(10);
+
+  for (int i = 0; i < kSamples; i++) {
+    SetHistogramBucket(i % kHistogramCount, i % 8);
+    if ((i + 1) % kSamplesPerTick == 0) {
+      task_environment_.FastForwardBy(kTick);
+    }
+  }
+  task_environment_.FastForwardBy(kFlushDelay);
+
+  // 1M samples over 10 simulated seconds, flushed at most once a second.
+  const base::TimeDelta recording_time = kTick * (kSamples / kSamplesPerTick);
+  const int max_flushes =
+      recording_time.InSeconds() / kFlushDelay.InSeconds() + 1;
+  EXPECT_LE(pref_writes_, max_flushes);
+  EXPECT_GT(pref_writes_, 0);
+
+  for (size_t i = 0; i < kHistogramCount; i++) {
+    const int last_sample = kSamples - kHistogramCount + i;
+    EXPECT_EQ(GetStoredValue(kHistograms[i]),
+              base::NumberToString(last_sample % 8));
+  }
+}
+
+}  // namespace brave
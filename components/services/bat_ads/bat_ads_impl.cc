@@ -71,6 +71,16 @@ void BatAdsImpl::OnPrefChanged(const std::string& path) {
   ads_->OnPrefChanged(path);
 }
 
+void BatAdsImpl::ShouldLoadHtml(const std::vector<std::string>& redirect_chain,
+                                ShouldLoadHtmlCallback callback) {
+  auto* holder = new CallbackHolder<ShouldLoadHtmlCallback>(
+      AsWeakPtr(), std::move(callback));
+
+  auto should_load_html_callback =
+      std::bind(BatAdsImpl::OnShouldLoadHtml, holder, _1);
+  ads_->ShouldLoadHtml(redirect_chain, should_load_html_callback);
+}
+
 void BatAdsImpl::OnHtmlLoaded(const int32_t tab_id,
                               const std::vector<std::string>& redirect_chain,
                               const std::string& html) {
@@ -319,6 +329,16 @@ void BatAdsImpl::OnGetInlineContentAd(
   delete holder;
 }
 
+void BatAdsImpl::OnShouldLoadHtml(
+    CallbackHolder<ShouldLoadHtmlCallback>* holder,
+    const bool should_load) {
+  if (holder->is_valid()) {
+    std::move(holder->get()).Run(should_load);
+  }
+
+  delete holder;
+}
+
 void BatAdsImpl::OnRemoveAllHistory(
     CallbackHolder<RemoveAllHistoryCallback>* holder,
     const bool success) {
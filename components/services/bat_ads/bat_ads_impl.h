@@ -49,6 +49,9 @@ class BatAdsImpl :
 
   void OnPrefChanged(const std::string& path) override;
 
+  void ShouldLoadHtml(const std::vector<std::string>& redirect_chain,
+                      ShouldLoadHtmlCallback callback) override;
+
   void OnHtmlLoaded(const int32_t tab_id,
                     const std::vector<std::string>& redirect_chain,
                     const std::string& html) override;
@@ -190,6 +193,10 @@ class BatAdsImpl :
         const std::string& dimensions,
         const ads::InlineContentAdInfo& ad);
 
+    static void OnShouldLoadHtml(
+        CallbackHolder<ShouldLoadHtmlCallback>* holder,
+        const bool should_load);
+
     static void OnRemoveAllHistory(
         CallbackHolder<RemoveAllHistoryCallback>* holder,
         const bool success);
@@ -5,6 +5,8 @@
 
 #include "brave/components/sync/engine/brave_model_type_worker.h"
 
+#include <algorithm>
+#include <string>
 #include <utility>
 
 #include "base/feature_list.h"
@@ -32,6 +34,53 @@ size_t kFailuresToResetMarker = 7;
 // Allow reset progress marker for type not often than once in 30 minutes
 base::TimeDelta kMinimalTimeBetweenResetMarker =
     base::TimeDelta::FromMinutes(30);
+// Before resetting the progress marker, first re-download only the changes
+// made to the type within this window
+base::TimeDelta kProgressMarkerRewindWindow = base::TimeDelta::FromDays(1);
+
+// Brave sync server encodes the progress marker token as a zigzag varint of
+// the latest entity mtime it returned, in milliseconds. It writes the varint
+// with Go's binary.PutVarint into a zero padded buffer of
+// binary.MaxVarintLen64 bytes.
+constexpr size_t kMaxVarintLength = 10;
+
+// Like Go's binary.Varint, bytes after the varint are ignored, as long as
+// they are the zero padding of the server's buffer. Any other token is not
+// one Brave sync server wrote.
+bool DecodeProgressMarkerToken(const std::string& token, int64_t* mtime) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < token.size() && i < kMaxVarintLength; ++i) {
+    const uint8_t byte = static_cast<uint8_t>(token[i]);
+    // The last byte only has room for the top bit of the value
+    if (i == kMaxVarintLength - 1 && byte > 1)
+      return false;
+    value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if (!(byte & 0x80)) {
+      if (token.size() > kMaxVarintLength ||
+          token.find_first_not_of('\0', i + 1) != std::string::npos)
+        return false;
+      *mtime = static_cast<int64_t>(value >> 1) ^
+               -static_cast<int64_t>(value & 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string EncodeProgressMarkerToken(int64_t mtime) {
+  uint64_t value = (static_cast<uint64_t>(mtime) << 1) ^
+                   static_cast<uint64_t>(mtime >> 63);
+  std::string token;
+  while (value >= 0x80) {
+    token.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  token.push_back(static_cast<char>(value));
+  // Padded the same way as the tokens the server writes
+  token.resize(kMaxVarintLength, '\0');
+  return token;
+}
+
 }  // namespace
 
 BraveModelTypeWorker::BraveModelTypeWorker(
@@ -63,7 +112,13 @@ void BraveModelTypeWorker::OnCommitResponse(
   }
 
   if (IsResetProgressMarkerRequired(error_response_list)) {
-    ResetProgressMarker();
+    // Try to heal the conflicts with the recent changes first, a full
+    // re-download of the type is only needed if that didn't help
+    if (!progress_marker_rewound_ && RewindProgressMarker()) {
+      failed_commit_times_ = 0;
+    } else {
+      ResetProgressMarker();
+    }
   }
 }
 
@@ -77,6 +132,11 @@ base::TimeDelta BraveModelTypeWorker::MinimalTimeBetweenResetForTests() {
   return kMinimalTimeBetweenResetMarker;
 }
 
+// static
+base::TimeDelta BraveModelTypeWorker::ProgressMarkerRewindWindowForTests() {
+  return kProgressMarkerRewindWindow;
+}
+
 bool BraveModelTypeWorker::IsResetProgressMarkerRequired(
     const FailedCommitResponseDataList& error_response_list) {
   if (!last_reset_marker_time_.is_null() &&
@@ -105,17 +165,38 @@ bool BraveModelTypeWorker::IsResetProgressMarkerRequired(
     ++failed_commit_times_;
   } else {
     failed_commit_times_ = 0;
+    progress_marker_rewound_ = false;
   }
 
   return failed_commit_times_ >= kFailuresToResetMarker;
 }
 
+bool BraveModelTypeWorker::RewindProgressMarker() {
+  int64_t mtime = 0;
+  if (!DecodeProgressMarkerToken(
+          model_type_state_.progress_marker().token(), &mtime)) {
+    return false;
+  }
+
+  VLOG(1) << "Rewind progress marker for type " << ModelTypeToString(type_);
+  // The next GetUpdates brings the server versions of entities changed within
+  // the window, the processor then resolves the pending local commits against
+  // them like against any other update
+  const int64_t rewound_mtime = std::max<int64_t>(
+      0, mtime - kProgressMarkerRewindWindow.InMilliseconds());
+  model_type_state_.mutable_progress_marker()->set_token(
+      EncodeProgressMarkerToken(rewound_mtime));
+  progress_marker_rewound_ = true;
+  return true;
+}
+
 void BraveModelTypeWorker::ResetProgressMarker() {
   VLOG(1) << "Reset progress marker for type " << ModelTypeToString(type_);
   // Normal reset of progress marker due to 7th failure
   // P3A sample is 0
   base::UmaHistogramExactLinear("Brave.Sync.ProgressTokenEverReset", 0, 1);
   last_reset_marker_time_ = base::Time::Now();
+  progress_marker_rewound_ = false;
   model_type_state_.mutable_progress_marker()->clear_token();
 }
 
@@ -31,6 +31,9 @@ FORWARD_DECLARE_TEST(BraveModelTypeWorkerTest, ResetProgressMarker);
 FORWARD_DECLARE_TEST(BraveModelTypeWorkerTest, ResetProgressMarkerMaxPeriod);
 FORWARD_DECLARE_TEST(BraveModelTypeWorkerTest,
                      ResetProgressMarkerDisabledFeature);
+FORWARD_DECLARE_TEST(BraveModelTypeWorkerTest, RewindProgressMarker);
+FORWARD_DECLARE_TEST(BraveModelTypeWorkerTest,
+                     RewindProgressMarkerDownloadsRecentEntities);
 
 class BraveModelTypeWorker : public ModelTypeWorker {
  public:
@@ -51,6 +54,9 @@ class BraveModelTypeWorker : public ModelTypeWorker {
                            ResetProgressMarkerMaxPeriod);
   FRIEND_TEST_ALL_PREFIXES(BraveModelTypeWorkerTest,
                            ResetProgressMarkerDisabledFeature);
+  FRIEND_TEST_ALL_PREFIXES(BraveModelTypeWorkerTest, RewindProgressMarker);
+  FRIEND_TEST_ALL_PREFIXES(BraveModelTypeWorkerTest,
+                           RewindProgressMarkerDownloadsRecentEntities);
 
   void OnCommitResponse(
       const CommitResponseDataList& committed_response_list,
@@ -58,12 +64,18 @@ class BraveModelTypeWorker : public ModelTypeWorker {
 
   bool IsResetProgressMarkerRequired(
       const FailedCommitResponseDataList& error_response_list);
+  // Moves the progress marker back by |kProgressMarkerRewindWindow|, so only
+  // the recent changes of the type get downloaded again. Returns false if the
+  // token is not in the format of Brave sync server.
+  bool RewindProgressMarker();
   void ResetProgressMarker();
 
   size_t failed_commit_times_ = 0;
+  bool progress_marker_rewound_ = false;
   base::Time last_reset_marker_time_;
   static size_t GetFailuresToResetMarkerForTests();
   static base::TimeDelta MinimalTimeBetweenResetForTests();
+  static base::TimeDelta ProgressMarkerRewindWindowForTests();
 };
 
 }  // namespace syncer
@@ -5,7 +5,11 @@
 
 #include "brave/components/sync/engine/brave_model_type_worker.h"
 
+#include <algorithm>
+#include <iterator>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/test/scoped_feature_list.h"
@@ -122,6 +126,56 @@ FailedCommitResponseDataList MakeErrorResponseList(
   return FailedCommitResponseDataList({data});
 }
 
+// Progress marker token as Brave sync server writes it, Go's
+// binary.PutVarint of the mtime in milliseconds into a buffer of
+// binary.MaxVarintLen64 bytes. |padded| keeps the unused bytes of the buffer.
+std::string MakeToken(int64_t mtime, bool padded = false) {
+  uint64_t value = static_cast<uint64_t>(mtime) << 1;
+  if (mtime < 0)
+    value = ~value;
+  std::string token;
+  for (; value >= 0x80; value >>= 7)
+    token.push_back(static_cast<char>(value | 0x80));
+  token.push_back(static_cast<char>(value));
+  if (padded)
+    token.resize(10, '\0');
+  return token;
+}
+
+// Go's binary.Varint, which stops at the first byte without the high bit
+int64_t ParseToken(const std::string& token) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < token.size(); ++i) {
+    value |= static_cast<uint64_t>(token[i] & 0x7f) << (7 * i);
+    if (!(token[i] & 0x80))
+      break;
+  }
+  const int64_t mtime = static_cast<int64_t>(value >> 1);
+  return value & 1 ? ~mtime : mtime;
+}
+
+// Stand-in for the GetUpdates handling of Brave sync server: everything
+// modified after the mtime in the progress marker gets downloaded
+class FakeBraveSyncServer {
+ public:
+  void AddEntity(int64_t mtime) { mtimes_.push_back(mtime); }
+
+  std::vector<int64_t> GetUpdates(const std::string& token) const {
+    const int64_t from = token.empty() ? 0 : ParseToken(token);
+    std::vector<int64_t> updates;
+    std::copy_if(mtimes_.begin(), mtimes_.end(), std::back_inserter(updates),
+                 [from](int64_t mtime) { return mtime > from; });
+    return updates;
+  }
+
+  size_t size() const { return mtimes_.size(); }
+
+ private:
+  std::vector<int64_t> mtimes_;
+};
+
+constexpr int64_t kTokenMtime = 1634567890123;
+
 }  // namespace
 
 TEST_F(BraveModelTypeWorkerTest, ResetProgressMarker) {
@@ -213,4 +267,107 @@ TEST_F(BraveModelTypeWorkerTest, ResetProgressMarkerDisabledFeature) {
   EXPECT_FALSE(IsProgressMarkerEmpty());
 }
 
+TEST_F(BraveModelTypeWorkerTest, RewindProgressMarker) {
+  NormalInitialize();
+  worker()->model_type_state_.mutable_progress_marker()->set_token(
+      MakeToken(kTokenMtime));
+  const int64_t rewound_mtime =
+      kTokenMtime -
+      BraveModelTypeWorker::ProgressMarkerRewindWindowForTests()
+          .InMilliseconds();
+  auto error_response_list =
+      MakeErrorResponseList(CommitResponse_ResponseType_CONFLICT);
+
+  for (size_t i = 0;
+       i < BraveModelTypeWorker::GetFailuresToResetMarkerForTests(); ++i) {
+    worker()->OnCommitResponse(CommitResponseDataList(), error_response_list);
+  }
+  // The first round of failures only rewinds the progress marker
+  EXPECT_EQ(ParseToken(worker()->model_type_state_.progress_marker().token()),
+            rewound_mtime);
+
+  // A successful commit means the rewind helped, the next round of failures
+  // rewinds again
+  worker()->OnCommitResponse(CommitResponseDataList(),
+                             FailedCommitResponseDataList());
+  worker()->model_type_state_.mutable_progress_marker()->set_token(
+      MakeToken(kTokenMtime));
+  for (size_t i = 0;
+       i < BraveModelTypeWorker::GetFailuresToResetMarkerForTests(); ++i) {
+    worker()->OnCommitResponse(CommitResponseDataList(), error_response_list);
+  }
+  EXPECT_EQ(ParseToken(worker()->model_type_state_.progress_marker().token()),
+            rewound_mtime);
+
+  // Failures going on after the rewind reset the marker completely
+  for (size_t i = 0;
+       i < BraveModelTypeWorker::GetFailuresToResetMarkerForTests() - 1; ++i) {
+    worker()->OnCommitResponse(CommitResponseDataList(), error_response_list);
+    EXPECT_FALSE(IsProgressMarkerEmpty());
+  }
+  worker()->OnCommitResponse(CommitResponseDataList(), error_response_list);
+  EXPECT_TRUE(IsProgressMarkerEmpty());
+}
+
+TEST_F(BraveModelTypeWorkerTest, RewindPaddedProgressMarker) {
+  NormalInitialize();
+  const std::string token = MakeToken(kTokenMtime, true);
+  ASSERT_EQ(token.size(), 10u);
+  worker()->model_type_state_.mutable_progress_marker()->set_token(token);
+  auto error_response_list =
+      MakeErrorResponseList(CommitResponse_ResponseType_CONFLICT);
+
+  for (size_t i = 0;
+       i < BraveModelTypeWorker::GetFailuresToResetMarkerForTests(); ++i) {
+    worker()->OnCommitResponse(CommitResponseDataList(), error_response_list);
+  }
+  EXPECT_EQ(ParseToken(worker()->model_type_state_.progress_marker().token()),
+            kTokenMtime -
+                BraveModelTypeWorker::ProgressMarkerRewindWindowForTests()
+                    .InMilliseconds());
+}
+
+TEST_F(BraveModelTypeWorkerTest, RewindProgressMarkerDownloadsRecentEntities) {
+  // 30 days of history, one entity every 30 seconds
+  constexpr int64_t kEntityInterval = 30 * 1000;
+  const int64_t history = base::TimeDelta::FromDays(30).InMilliseconds();
+  FakeBraveSyncServer server;
+  for (int64_t age = 0; age < history; age += kEntityInterval)
+    server.AddEntity(kTokenMtime - age);
+  // The entity the commits conflict with, the client never received its
+  // latest version
+  const int64_t conflict_mtime =
+      kTokenMtime - base::TimeDelta::FromHours(1).InMilliseconds();
+  server.AddEntity(conflict_mtime);
+
+  NormalInitialize();
+  worker()->model_type_state_.mutable_progress_marker()->set_token(
+      MakeToken(kTokenMtime));
+  auto error_response_list =
+      MakeErrorResponseList(CommitResponse_ResponseType_CONFLICT);
+  for (size_t i = 0;
+       i < BraveModelTypeWorker::GetFailuresToResetMarkerForTests(); ++i) {
+    worker()->OnCommitResponse(CommitResponseDataList(), error_response_list);
+  }
+
+  const std::vector<int64_t> recovery_updates = server.GetUpdates(
+      worker()->model_type_state_.progress_marker().token());
+  EXPECT_NE(std::find(recovery_updates.begin(), recovery_updates.end(),
+                      conflict_mtime),
+            recovery_updates.end());
+  // One day of changes out of thirty
+  EXPECT_LT(recovery_updates.size(), server.size() / 25);
+
+  // Only if conflicts persist everything is downloaded again
+  for (size_t i = 0;
+       i < BraveModelTypeWorker::GetFailuresToResetMarkerForTests(); ++i) {
+    worker()->OnCommitResponse(CommitResponseDataList(), error_response_list);
+  }
+  EXPECT_EQ(
+      server
+          .GetUpdates(worker()->model_type_state_.progress_marker().token())
+          .size(),
+      server.size());
+}
+
 }  // namespace syncer
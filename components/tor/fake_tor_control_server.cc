@@ -0,0 +1,121 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/tor/fake_tor_control_server.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/socket/stream_socket.h"
+#include "net/socket/tcp_server_socket.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace tor {
+
+namespace {
+constexpr int kReadBufferSize = 4096;
+}  // namespace
+
+FakeTorControlServer::FakeTorControlServer()
+    : handler_(base::BindRepeating(
+          [](const std::string& cmd) -> std::string { return "250 OK\r\n"; })) {
+}
+
+FakeTorControlServer::~FakeTorControlServer() = default;
+
+int FakeTorControlServer::Listen() {
+  server_socket_ =
+      std::make_unique<net::TCPServerSocket>(nullptr, net::NetLogSource());
+  EXPECT_EQ(net::OK,
+            server_socket_->Listen(
+                net::IPEndPoint(net::IPAddress::IPv4Localhost(), 0), 1));
+  net::IPEndPoint endpoint;
+  EXPECT_EQ(net::OK, server_socket_->GetLocalAddress(&endpoint));
+  int rv = server_socket_->Accept(
+      &socket_, base::BindOnce(&FakeTorControlServer::OnAccept,
+                               base::Unretained(this)));
+  if (rv != net::ERR_IO_PENDING)
+    OnAccept(rv);
+  return endpoint.port();
+}
+
+void FakeTorControlServer::Send(const std::string& data) {
+  write_data_ += data;
+  if (socket_ && !write_buf_)
+    DoWrite();
+}
+
+void FakeTorControlServer::OnAccept(int rv) {
+  ASSERT_EQ(net::OK, rv);
+  read_buf_ = base::MakeRefCounted<net::IOBuffer>(kReadBufferSize);
+  DoRead();
+  if (!write_buf_)
+    DoWrite();
+}
+
+void FakeTorControlServer::DoRead() {
+  int rv;
+  while ((rv = socket_->Read(read_buf_.get(), kReadBufferSize,
+                             base::BindOnce(&FakeTorControlServer::OnRead,
+                                            base::Unretained(this)))) !=
+         net::ERR_IO_PENDING) {
+    if (!HandleRead(rv))
+      return;
+  }
+}
+
+void FakeTorControlServer::OnRead(int rv) {
+  if (HandleRead(rv))
+    DoRead();
+}
+
+bool FakeTorControlServer::HandleRead(int rv) {
+  if (rv <= 0)
+    return false;
+  pending_.append(read_buf_->data(), rv);
+  size_t crlf;
+  while ((crlf = pending_.find("\r\n")) != std::string::npos) {
+    const std::string cmd = pending_.substr(0, crlf);
+    pending_.erase(0, crlf + 2);
+    Send(handler_.Run(cmd));
+  }
+  return true;
+}
+
+void FakeTorControlServer::DoWrite() {
+  while (!write_data_.empty() || write_buf_) {
+    if (!write_buf_) {
+      auto buf = base::MakeRefCounted<net::StringIOBuffer>(write_data_);
+      write_data_.clear();
+      write_buf_ =
+          base::MakeRefCounted<net::DrainableIOBuffer>(buf, buf->size());
+    }
+    int rv = socket_->Write(write_buf_.get(), write_buf_->BytesRemaining(),
+                            base::BindOnce(&FakeTorControlServer::OnWrite,
+                                           base::Unretained(this)),
+                            TRAFFIC_ANNOTATION_FOR_TESTS);
+    if (rv == net::ERR_IO_PENDING)
+      return;
+    ASSERT_GT(rv, 0);
+    write_buf_->DidConsume(rv);
+    if (!write_buf_->BytesRemaining())
+      write_buf_.reset();
+  }
+}
+
+void FakeTorControlServer::OnWrite(int rv) {
+  ASSERT_GT(rv, 0);
+  write_buf_->DidConsume(rv);
+  if (!write_buf_->BytesRemaining())
+    write_buf_.reset();
+  DoWrite();
+}
+
+}  // namespace tor
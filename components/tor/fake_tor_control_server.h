@@ -0,0 +1,67 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_TOR_FAKE_TOR_CONTROL_SERVER_H_
+#define BRAVE_COMPONENTS_TOR_FAKE_TOR_CONTROL_SERVER_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+
+namespace net {
+class DrainableIOBuffer;
+class IOBuffer;
+class StreamSocket;
+class TCPServerSocket;
+}  // namespace net
+
+namespace tor {
+
+// Minimal Tor control port listening on localhost for tests.  Accepts one
+// connection and answers each command line with whatever |handler| returns
+// (`250 OK' by default).  Must be used on a sequence with an IO message pump.
+class FakeTorControlServer {
+ public:
+  using CommandHandler =
+      base::RepeatingCallback<std::string(const std::string& cmd)>;
+
+  FakeTorControlServer();
+  ~FakeTorControlServer();
+
+  // Starts listening and returns the port.
+  int Listen();
+
+  void set_command_handler(CommandHandler handler) {
+    handler_ = std::move(handler);
+  }
+
+  // Writes raw |data|, e.g. async events, to the connected client.
+  void Send(const std::string& data);
+
+ private:
+  void OnAccept(int rv);
+  void DoRead();
+  void OnRead(int rv);
+  bool HandleRead(int rv);
+  void DoWrite();
+  void OnWrite(int rv);
+
+  CommandHandler handler_;
+  std::unique_ptr<net::TCPServerSocket> server_socket_;
+  std::unique_ptr<net::StreamSocket> socket_;
+  scoped_refptr<net::IOBuffer> read_buf_;
+  std::string pending_;
+  std::string write_data_;
+  scoped_refptr<net::DrainableIOBuffer> write_buf_;
+
+  FakeTorControlServer(const FakeTorControlServer&) = delete;
+  FakeTorControlServer& operator=(const FakeTorControlServer&) = delete;
+};
+
+}  // namespace tor
+
+#endif  // BRAVE_COMPONENTS_TOR_FAKE_TOR_CONTROL_SERVER_H_
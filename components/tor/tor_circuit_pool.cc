@@ -0,0 +1,270 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/tor/tor_circuit_pool.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/bind_post_task.h"
+#include "base/callback_helpers.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/string_split.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "brave/components/tor/tor_control.h"
+
+namespace tor {
+
+namespace {
+
+// Number of distinct sites we remember having prewarmed for.
+constexpr size_t kRecentPrewarmsSize = 32;
+
+// Circuits closing is routine so the first failure refills right away; after
+// that refills back off from 1s up to a minute until a circuit gets built.
+constexpr net::BackoffEntry::Policy kRetryBackoffPolicy = {
+    1,          // num_errors_to_ignore
+    1000,       // initial_delay_ms
+    2.0,        // multiply_factor
+    0.2,        // jitter_factor
+    60 * 1000,  // maximum_backoff_ms
+    -1,         // entry_lifetime_ms
+    false,      // always_use_initial_delay
+};
+
+constexpr char kCircBuilt[] = "BUILT";
+constexpr char kCircFailed[] = "FAILED";
+constexpr char kCircClosed[] = "CLOSED";
+constexpr char kStreamNew[] = "NEW";
+constexpr char kStreamNewResolve[] = "NEWRESOLVE";
+
+}  // namespace
+
+TorCircuitPool::TorCircuitPool(TorControl* control, size_t size)
+    : control_(control),
+      size_(size),
+      recent_prewarms_(kRecentPrewarmsSize),
+      retry_backoff_(&kRetryBackoffPolicy) {
+  DCHECK(control_);
+}
+
+TorCircuitPool::~TorCircuitPool() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void TorCircuitPool::Start() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (running_)
+    return;
+  running_ = true;
+  if (!subscribed_) {
+    subscribed_ = true;
+    control_->Subscribe(TorControlEvent::CIRC, base::DoNothing::Once<bool>());
+    control_->Subscribe(TorControlEvent::STREAM,
+                        base::DoNothing::Once<bool>());
+  }
+  Fill();
+}
+
+void TorCircuitPool::Stop() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (subscribed_) {
+    subscribed_ = false;
+    control_->Unsubscribe(TorControlEvent::CIRC,
+                          base::DoNothing::Once<bool>());
+    control_->Unsubscribe(TorControlEvent::STREAM,
+                          base::DoNothing::Once<bool>());
+  }
+  running_ = false;
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  building_.clear();
+  clean_.clear();
+  pending_extends_ = 0;
+  early_circuit_status_.clear();
+  prewarm_demand_ = 0;
+  recent_prewarms_.Clear();
+  retry_timer_.Stop();
+  retry_backoff_.Reset();
+}
+
+// OnCircuitEvent(initial)
+//
+//      `CircuitID CircStatus [Path] ...'.  Move circuits we asked for
+//      from building to clean once built, and forget about them once
+//      they fail or close.
+//
+void TorCircuitPool::OnCircuitEvent(const std::string& initial) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!running_)
+    return;
+  const std::vector<std::string> fields = base::SplitString(
+      initial, " ", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (fields.size() < 2)
+    return;
+  const std::string& id = fields[0];
+  const std::string& status = fields[1];
+
+  auto building = building_.find(id);
+  if (building != building_.end()) {
+    if (status == kCircBuilt) {
+      const base::TimeTicks start = building->second;
+      building_.erase(building);
+      OnCircuitBuilt(id, start);
+    } else if (status == kCircFailed || status == kCircClosed) {
+      building_.erase(building);
+      OnCircuitFailed();
+    }
+    return;
+  }
+
+  if ((status == kCircFailed || status == kCircClosed) && clean_.erase(id)) {
+    OnCircuitFailed();
+    return;
+  }
+
+  // Possibly one of ours whose EXTENDCIRCUIT reply hasn't arrived yet.
+  if (pending_extends_ && !clean_.count(id) &&
+      (status == kCircBuilt || status == kCircFailed ||
+       status == kCircClosed)) {
+    early_circuit_status_[id] = status;
+  }
+}
+
+// OnStreamEvent(initial)
+//
+//      `StreamID StreamStatus CircuitID Target ...'.  A stream attached
+//      to one of our clean circuits makes it dirty: drop it from the
+//      pool and build a replacement.
+//
+void TorCircuitPool::OnStreamEvent(const std::string& initial) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!running_)
+    return;
+  const std::vector<std::string> fields = base::SplitString(
+      initial, " ", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (fields.size() < 3)
+    return;
+  const std::string& status = fields[1];
+  if (status == kStreamNew || status == kStreamNewResolve)
+    return;
+  if (!clean_.erase(fields[2]))
+    return;
+  if (prewarm_demand_)
+    prewarm_demand_--;
+  Fill();
+}
+
+void TorCircuitPool::Prewarm(const std::string& isolation_key) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!running_ || isolation_key.empty())
+    return;
+  if (recent_prewarms_.Get(isolation_key) != recent_prewarms_.end())
+    return;
+  recent_prewarms_.Put(isolation_key, true);
+  if (prewarm_demand_ >= size_)
+    return;
+  prewarm_demand_++;
+  Fill();
+}
+
+void TorCircuitPool::Fill() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Backing off; the retry timer fills the pool when it fires.
+  if (retry_timer_.IsRunning()) {
+    NotifyPoolChanged();
+    return;
+  }
+  const size_t wanted = size_ + prewarm_demand_;
+  size_t have = clean_.size() + building_.size() + pending_extends_;
+  for (; have < wanted; have++)
+    BuildCircuit();
+  NotifyPoolChanged();
+}
+
+void TorCircuitPool::BuildCircuit() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  pending_extends_++;
+  control_->ExtendCircuit(base::BindPostTask(
+      base::SequencedTaskRunnerHandle::Get(),
+      base::BindOnce(&TorCircuitPool::OnExtendCircuit,
+                     weak_ptr_factory_.GetWeakPtr(), base::TimeTicks::Now())));
+}
+
+void TorCircuitPool::OnExtendCircuit(base::TimeTicks start,
+                                     bool error,
+                                     const std::string& circuit_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_GT(pending_extends_, 0u);
+  pending_extends_--;
+
+  std::string early_status;
+  auto early = early_circuit_status_.find(circuit_id);
+  if (!error && early != early_circuit_status_.end())
+    early_status = early->second;
+  // Nothing else can claim statuses recorded while no command is in flight.
+  if (!pending_extends_)
+    early_circuit_status_.clear();
+  else if (early != early_circuit_status_.end())
+    early_circuit_status_.erase(early);
+
+  if (error) {
+    VLOG(1) << "tor: failed to build pool circuit";
+    OnCircuitFailed();
+    return;
+  }
+
+  if (early_status == kCircBuilt) {
+    OnCircuitBuilt(circuit_id, start);
+    return;
+  }
+  if (early_status == kCircFailed || early_status == kCircClosed) {
+    OnCircuitFailed();
+    return;
+  }
+  building_[circuit_id] = start;
+  NotifyPoolChanged();
+}
+
+void TorCircuitPool::OnCircuitBuilt(const std::string& circuit_id,
+                                    base::TimeTicks start) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  UMA_HISTOGRAM_MEDIUM_TIMES("Brave.Tor.CircuitBuildTime",
+                             base::TimeTicks::Now() - start);
+  clean_.insert(circuit_id);
+  retry_backoff_.Reset();
+  if (retry_timer_.IsRunning()) {
+    // Tor is building circuits again, no need to wait out the backoff.
+    retry_timer_.Stop();
+    Fill();
+    return;
+  }
+  NotifyPoolChanged();
+}
+
+void TorCircuitPool::OnCircuitFailed() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  retry_backoff_.InformOfRequest(false);
+  if (retry_timer_.IsRunning()) {
+    NotifyPoolChanged();
+    return;
+  }
+  const base::TimeDelta delay = retry_backoff_.GetTimeUntilRelease();
+  if (delay.is_zero()) {
+    Fill();
+    return;
+  }
+  retry_timer_.Start(FROM_HERE, delay,
+                     base::BindOnce(&TorCircuitPool::Fill,
+                                    base::Unretained(this)));
+  NotifyPoolChanged();
+}
+
+void TorCircuitPool::NotifyPoolChanged() {
+  if (pool_changed_callback_for_testing_)
+    pool_changed_callback_for_testing_.Run();
+}
+
+}  // namespace tor
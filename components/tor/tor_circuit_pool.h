@@ -0,0 +1,106 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_TOR_TOR_CIRCUIT_POOL_H_
+#define BRAVE_COMPONENTS_TOR_TOR_CIRCUIT_POOL_H_
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "net/base/backoff_entry.h"
+
+namespace tor {
+
+class TorControl;
+
+// Keeps a small number of clean (never used) circuits built ahead of time so
+// that the first stream with a new SOCKS isolation key, i.e. the first load
+// of a new site in a Tor window, does not have to wait for a full circuit
+// build.  Tor attaches a stream with a new isolation key to a clean circuit
+// when one is available, so the pool only has to keep clean circuits around
+// and top them up as they get used; it learns about that from CIRC and
+// STREAM events which the owner forwards.
+//
+// Lives on the same sequence as the TorControl owner.
+class TorCircuitPool {
+ public:
+  static constexpr size_t kDefaultSize = 2;
+
+  TorCircuitPool(TorControl* control, size_t size);
+  ~TorCircuitPool();
+
+  // Call once the control channel is ready / has closed.
+  void Start();
+  void Stop();
+
+  // Forwarded TorControlEvent::CIRC and TorControlEvent::STREAM events.
+  void OnCircuitEvent(const std::string& initial);
+  void OnStreamEvent(const std::string& initial);
+
+  // Navigation intent for a site with |isolation_key|; build one more clean
+  // circuit unless we already did so for that key recently.
+  void Prewarm(const std::string& isolation_key);
+
+  size_t clean_size() const { return clean_.size(); }
+  size_t building_size() const { return building_.size(); }
+
+  void set_pool_changed_callback_for_testing(base::RepeatingClosure callback) {
+    pool_changed_callback_for_testing_ = std::move(callback);
+  }
+  base::OneShotTimer* retry_timer_for_testing() { return &retry_timer_; }
+
+ private:
+  void Fill();
+  void BuildCircuit();
+  void OnExtendCircuit(base::TimeTicks start,
+                       bool error,
+                       const std::string& circuit_id);
+  void OnCircuitBuilt(const std::string& circuit_id, base::TimeTicks start);
+  void OnCircuitFailed();
+  void NotifyPoolChanged();
+
+  TorControl* control_;  // NOT OWNED
+  const size_t size_;
+  bool running_ = false;
+  bool subscribed_ = false;
+
+  // Circuits we asked for which are not built yet, with build start time.
+  std::map<std::string, base::TimeTicks> building_;
+  // Built circuits no stream has been attached to yet.
+  std::set<std::string> clean_;
+  // EXTENDCIRCUIT commands in flight, whose circuit id isn't known yet.
+  size_t pending_extends_ = 0;
+  // Last CIRC status seen for unknown circuits while EXTENDCIRCUIT commands
+  // are in flight.  The event can overtake the command reply, in which case
+  // the reply is reconciled against it.
+  std::map<std::string, std::string> early_circuit_status_;
+  // Extra clean circuits requested by Prewarm() and not yet consumed.
+  size_t prewarm_demand_ = 0;
+  base::MRUCache<std::string, bool> recent_prewarms_;
+  // Failures since the last circuit was built.  Refills after a failure wait
+  // for |retry_timer_| so a broken network doesn't turn into a rebuild loop.
+  net::BackoffEntry retry_backoff_;
+  base::OneShotTimer retry_timer_;
+
+  base::RepeatingClosure pool_changed_callback_for_testing_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<TorCircuitPool> weak_ptr_factory_{this};
+
+  TorCircuitPool(const TorCircuitPool&) = delete;
+  TorCircuitPool& operator=(const TorCircuitPool&) = delete;
+};
+
+}  // namespace tor
+
+#endif  // BRAVE_COMPONENTS_TOR_TOR_CIRCUIT_POOL_H_
@@ -0,0 +1,263 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/tor/tor_circuit_pool.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "brave/components/tor/fake_tor_control_server.h"
+#include "brave/components/tor/tor_control.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace tor {
+
+namespace {
+
+// Forwards control events to the pool, the way TorLauncherFactory does.
+class PoolTorControlDelegate : public TorControl::Delegate {
+ public:
+  void set_pool(TorCircuitPool* pool) { pool_ = pool; }
+
+  void OnTorControlReady() override { pool_->Start(); }
+  void OnTorControlClosed(bool was_running) override { pool_->Stop(); }
+  void OnTorEvent(TorControlEvent event,
+                  const std::string& initial,
+                  const std::map<std::string, std::string>& extra) override {
+    if (event == TorControlEvent::CIRC)
+      pool_->OnCircuitEvent(initial);
+    else if (event == TorControlEvent::STREAM)
+      pool_->OnStreamEvent(initial);
+  }
+
+ private:
+  TorCircuitPool* pool_ = nullptr;
+};
+
+}  // namespace
+
+class TorCircuitPoolTest : public testing::Test {
+ public:
+  TorCircuitPoolTest()
+      : task_environment_(base::test::TaskEnvironment::MainThreadType::IO) {}
+
+  void SetUp() override {
+    // Answer EXTENDCIRCUIT with a fresh id and report it built right away.
+    server_.set_command_handler(base::BindRepeating(
+        [](TorCircuitPoolTest* test, const std::string& cmd) -> std::string {
+          if (base::StartsWith(cmd, "SETEVENTS",
+                               base::CompareCase::SENSITIVE))
+            test->last_setevents_ = cmd;
+          if (!base::StartsWith(cmd, "EXTENDCIRCUIT",
+                                base::CompareCase::SENSITIVE))
+            return "250 OK\r\n";
+          const int id = ++test->next_circuit_id_;
+          test->extend_cmds_++;
+          if (test->built_before_reply_) {
+            return base::StringPrintf(
+                "650 CIRC %d LAUNCHED PURPOSE=GENERAL\r\n"
+                "650 CIRC %d BUILT $AAAA~relay1,$BBBB~relay2,$CCCC~relay3 "
+                "PURPOSE=GENERAL\r\n"
+                "250 EXTENDED %d\r\n",
+                id, id, id);
+          }
+          if (test->fail_builds_) {
+            return base::StringPrintf(
+                "250 EXTENDED %d\r\n"
+                "650 CIRC %d LAUNCHED PURPOSE=GENERAL\r\n"
+                "650 CIRC %d FAILED PURPOSE=GENERAL REASON=TIMEOUT\r\n",
+                id, id, id);
+          }
+          return base::StringPrintf(
+              "250 EXTENDED %d\r\n"
+              "650 CIRC %d LAUNCHED PURPOSE=GENERAL\r\n"
+              "650 CIRC %d BUILT $AAAA~relay1,$BBBB~relay2,$CCCC~relay3 "
+              "PURPOSE=GENERAL\r\n",
+              id, id, id);
+        },
+        base::Unretained(this)));
+    const int port = server_.Listen();
+
+    control_ = std::make_unique<TorControl>(
+        delegate_.AsWeakPtr(), base::SequencedTaskRunnerHandle::Get());
+    pool_ =
+        std::make_unique<TorCircuitPool>(control_.get(), /* size = */ 2);
+    delegate_.set_pool(pool_.get());
+    control_->Start(std::vector<uint8_t>(32, 0), port);
+  }
+
+  void TearDown() override {
+    control_->Stop();
+    base::RunLoop().RunUntilIdle();
+    pool_.reset();
+    control_.reset();
+  }
+
+  // Spins until the pool has |clean| built circuits and nothing in flight.
+  void WaitForCleanCircuits(size_t clean) {
+    if (pool_->clean_size() == clean && !pool_->building_size())
+      return;
+    base::RunLoop run_loop;
+    pool_->set_pool_changed_callback_for_testing(base::BindRepeating(
+        [](TorCircuitPool* pool, size_t clean, base::RunLoop* run_loop) {
+          if (pool->clean_size() == clean && !pool->building_size())
+            run_loop->Quit();
+        },
+        pool_.get(), clean, &run_loop));
+    run_loop.Run();
+    pool_->set_pool_changed_callback_for_testing(base::RepeatingClosure());
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  FakeTorControlServer server_;
+  PoolTorControlDelegate delegate_;
+  std::unique_ptr<TorControl> control_;
+  std::unique_ptr<TorCircuitPool> pool_;
+  int next_circuit_id_ = 0;
+  int extend_cmds_ = 0;
+  bool built_before_reply_ = false;
+  bool fail_builds_ = false;
+  std::string last_setevents_;
+};
+
+TEST_F(TorCircuitPoolTest, FillsOnStart) {
+  base::HistogramTester histogram_tester;
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(extend_cmds_, 2);
+  histogram_tester.ExpectTotalCount("Brave.Tor.CircuitBuildTime", 2);
+}
+
+TEST_F(TorCircuitPoolTest, RefillsWhenCircuitUsed) {
+  WaitForCleanCircuits(2);
+
+  // A stream for a new isolation key lands on pooled circuit 1.
+  server_.Send("650 STREAM 10 NEW 0 example.com:443\r\n"
+               "650 STREAM 10 SENTCONNECT 1 example.com:443\r\n");
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(extend_cmds_, 3);
+
+  // Streams on circuits we don't own leave the pool alone.
+  server_.Send("650 STREAM 11 SUCCEEDED 1 example.com:443\r\n"
+               "650 STREAM 12 SENTCONNECT 99 example.net:443\r\n");
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(pool_->clean_size(), 2u);
+  EXPECT_EQ(extend_cmds_, 3);
+}
+
+TEST_F(TorCircuitPoolTest, RefillsWhenCircuitClosed) {
+  WaitForCleanCircuits(2);
+  server_.Send("650 CIRC 2 CLOSED REASON=FINISHED\r\n");
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(extend_cmds_, 3);
+}
+
+TEST_F(TorCircuitPoolTest, Prewarm) {
+  WaitForCleanCircuits(2);
+
+  pool_->Prewarm("example.com");
+  WaitForCleanCircuits(3);
+  EXPECT_EQ(extend_cmds_, 3);
+
+  // Repeated intent for the same site doesn't build more.
+  pool_->Prewarm("example.com");
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(pool_->clean_size(), 3u);
+  EXPECT_EQ(extend_cmds_, 3);
+
+  // Once the site uses a circuit the extra demand is satisfied and the pool
+  // settles back to its target size.
+  server_.Send("650 STREAM 10 SENTCONNECT 3 example.com:443\r\n");
+  base::RunLoop().RunUntilIdle();
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(extend_cmds_, 3);
+}
+
+TEST_F(TorCircuitPoolTest, CircuitBuiltBeforeExtendReply) {
+  WaitForCleanCircuits(2);
+
+  // Tor may report the new circuit built before answering EXTENDCIRCUIT.
+  built_before_reply_ = true;
+  server_.Send("650 CIRC 1 CLOSED REASON=FINISHED\r\n");
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(extend_cmds_, 3);
+  EXPECT_EQ(pool_->building_size(), 0u);
+
+  // The pool isn't starved by a circuit stuck in building.
+  server_.Send("650 CIRC 2 CLOSED REASON=FINISHED\r\n");
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(extend_cmds_, 4);
+}
+
+TEST_F(TorCircuitPoolTest, BacksOffWhenBuildsFail) {
+  WaitForCleanCircuits(2);
+
+  // Every new circuit fails: the first failure refills right away, after
+  // that the pool waits for the retry timer instead of rebuilding in a loop.
+  fail_builds_ = true;
+  base::RunLoop run_loop;
+  pool_->set_pool_changed_callback_for_testing(base::BindRepeating(
+      [](TorCircuitPool* pool, base::RunLoop* run_loop) {
+        if (pool->retry_timer_for_testing()->IsRunning())
+          run_loop->Quit();
+      },
+      pool_.get(), &run_loop));
+  server_.Send("650 CIRC 1 CLOSED REASON=FINISHED\r\n");
+  run_loop.Run();
+  pool_->set_pool_changed_callback_for_testing(base::RepeatingClosure());
+  EXPECT_EQ(pool_->clean_size(), 1u);
+  EXPECT_EQ(extend_cmds_, 3);
+
+  // More failures while backing off don't build anything.
+  server_.Send("650 CIRC 2 CLOSED REASON=FINISHED\r\n");
+  WaitForCleanCircuits(0);
+  EXPECT_EQ(extend_cmds_, 3);
+  EXPECT_TRUE(pool_->retry_timer_for_testing()->IsRunning());
+
+  // Once a retry builds a circuit the backoff is reset.
+  fail_builds_ = false;
+  pool_->retry_timer_for_testing()->FireNow();
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(extend_cmds_, 5);
+  EXPECT_FALSE(pool_->retry_timer_for_testing()->IsRunning());
+  server_.Send("650 CIRC 4 CLOSED REASON=FINISHED\r\n");
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(extend_cmds_, 6);
+}
+
+TEST_F(TorCircuitPoolTest, StopUnsubscribes) {
+  WaitForCleanCircuits(2);
+  EXPECT_EQ(last_setevents_, "SETEVENTS CIRC STREAM");
+
+  pool_->Stop();
+  base::RunLoop run_loop;
+  server_.set_command_handler(base::BindRepeating(
+      [](TorCircuitPoolTest* test, base::RunLoop* run_loop,
+         const std::string& cmd) -> std::string {
+        test->last_setevents_ = cmd;
+        if (cmd == "SETEVENTS")
+          run_loop->Quit();
+        return "250 OK\r\n";
+      },
+      base::Unretained(this), &run_loop));
+  run_loop.Run();
+  EXPECT_EQ(pool_->clean_size(), 0u);
+
+  // Events after Stop() are ignored.
+  server_.Send("650 CIRC 7 BUILT PURPOSE=GENERAL\r\n");
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(pool_->clean_size(), 0u);
+}
+
+}  // namespace tor
@@ -5,6 +5,8 @@
 
 #include "brave/components/tor/tor_control.h"
 
+#include <cstring>
+
 #include "base/sequenced_task_runner.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
@@ -35,6 +37,9 @@ const net::NetworkTrafficAnnotationTag tor_control_traffic_annotation =
   )");
 
 const size_t kTorBufferSize = 4096;
+// Longest single line we are willing to buffer.  Data replies are
+// accumulated line by line, so this only bounds individual lines.
+const int kTorMaxLineSize = 1024 * 1024;
 
 constexpr char kGetVersionCmd[] = "GETINFO version";
 constexpr char kGetVersionReply[] = "version=";
@@ -43,6 +48,8 @@ constexpr char kGetSOCKSListenersReply[] = "net/listeners/socks=";
 constexpr char kGetCircuitEstablishedCmd[] =
     "GETINFO status/circuit-established";
 constexpr char kGetCircuitEstablishedReply[] = "status/circuit-established=";
+constexpr char kExtendCircuitCmd[] = "EXTENDCIRCUIT 0 purpose=general";
+constexpr char kExtendCircuitReply[] = "EXTENDED ";
 
 static std::string escapify(const char* buf, int len) {
   std::ostringstream s;
@@ -86,7 +93,6 @@ TorControl::TorControl(base::WeakPtr<TorControl::Delegate> delegate,
       writing_(false),
       reading_(false),
       read_start_(-1),
-      read_cr_(false),
       delegate_(delegate) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
   DETACH_FROM_SEQUENCE(io_sequence_checker_);
@@ -269,7 +275,7 @@ void TorControl::Subscribed(TorControlEvent event,
 //
 //      Unsubscribe to the named asynchronous event by sending
 //      SETEVENTS with it excluded from all otherwise subscribed
-//      events.  Caller must already be subscribed.  If used after
+//      events.  Fails if not subscribed, e.g. after Stop.  If used after
 //      repeated Subscribe with the same event, just decrement nesting
 //      depth without sending SETEVENTS.  Call the callback once the
 //      unsubscription has been processed.  Subsequently, the event
@@ -287,8 +293,13 @@ void TorControl::Unsubscribe(TorControlEvent event,
 void TorControl::DoUnsubscribe(TorControlEvent event,
                                base::OnceCallback<void(bool error)> callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
-  // We had better already be subscribed.
-  DCHECK_GE(async_events_[event], 1u);
+  // Subscriptions are dropped when the control channel is stopped, which
+  // may happen before a subscriber gets to unsubscribe.
+  if (!async_events_.count(event)) {
+    bool error = true;
+    std::move(callback).Run(error);
+    return;
+  }
   if (--async_events_[event] != 0) {
     bool error = false;
     std::move(callback).Run(error);
@@ -516,6 +527,43 @@ void TorControl::GetCircuitEstablishedDone(
   std::move(callback).Run(false, result);
 }
 
+// ExtendCircuit(callback)
+//
+//      Build a fresh circuit and call callback(error, circuit_id).
+//
+void TorControl::ExtendCircuit(
+    base::OnceCallback<void(bool error, const std::string& circuit_id)>
+        callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
+  io_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          &TorControl::DoCmd, weak_ptr_factory_.GetWeakPtr(),
+          kExtendCircuitCmd,
+          base::DoNothing::Repeatedly<const std::string&,
+                                      const std::string&>(),
+          base::BindOnce(&TorControl::ExtendCircuitDone,
+                         weak_ptr_factory_.GetWeakPtr(),
+                         std::move(callback))));
+}
+
+void TorControl::ExtendCircuitDone(
+    base::OnceCallback<void(bool error, const std::string& circuit_id)>
+        callback,
+    bool error,
+    const std::string& status,
+    const std::string& reply) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  if (error || status != "250" ||
+      !base::StartsWith(reply, kExtendCircuitReply,
+                        base::CompareCase::SENSITIVE) ||
+      reply.size() == strlen(kExtendCircuitReply)) {
+    std::move(callback).Run(true, "");
+    return;
+  }
+  std::move(callback).Run(false, reply.substr(strlen(kExtendCircuitReply)));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Writing state machine
 
@@ -697,61 +745,59 @@ void TorControl::ReadDone(int rv) {
     Error();
     return;
   }
-  const char* data = readiobuf_->data();
-  for (int i = 0; i < rv; i++) {
-    if (!read_cr_) {
-      // No CR yet.  Accept CR or non-LF; reject LF.
-      if (data[i] == 0x0d) {  // CR
-        read_cr_ = true;
-      } else if (data[i] == 0x0a) {  // LF
-        VLOG(1) << "tor: stray line feed";
-        Error();
-        return;
-      } else {
-        // Anything else: Just accept it and move on.
-      }
-    } else {
-      // CR seen.  Accept LF; reject all else.
-      if (data[i] == 0x0a) {  // LF
-        // CRLF seen, so we must have i >= 2.  Emit a line and advance
-        // to the next one, unless anything went wrong with the line.
-        assert(i >= 1);
-        std::string line(readiobuf_->StartOfBuffer() + read_start_,
-                         readiobuf_->offset() + i - 1 - read_start_);
-        read_start_ = readiobuf_->offset() + i + 1;
-        read_cr_ = false;
-        if (!ReadLine(line)) {
-          reading_ = false;
-          return;
-        }
-      } else {
-        // CR seen, but not LF.  Bad.
-        VLOG(1) << "tor: stray carriage return";
-        Error();
-        return;
-      }
+  // Scan only the newly read octets for line feeds; everything before
+  // them has already been searched.  Each line is handed to ReadLine as
+  // a view into readiobuf_, so no per-line copy is made here.
+  const char* buf = readiobuf_->StartOfBuffer();
+  const int end = readiobuf_->offset() + rv;
+  int scan = readiobuf_->offset();
+  while (scan < end) {
+    const char* lf =
+        static_cast<const char*>(memchr(buf + scan, '\n', end - scan));
+    if (!lf)
+      break;
+    const int lf_pos = lf - buf;
+    if (lf_pos == read_start_ || buf[lf_pos - 1] != '\r') {
+      VLOG(1) << "tor: stray line feed";
+      Error();
+      return;
+    }
+    base::StringPiece line(buf + read_start_, lf_pos - 1 - read_start_);
+    if (line.find('\r') != base::StringPiece::npos) {
+      VLOG(1) << "tor: stray carriage return";
+      Error();
+      return;
+    }
+    read_start_ = lf_pos + 1;
+    scan = read_start_;
+    if (!ReadLine(line)) {
+      reading_ = false;
+      return;
     }
   }
+  readiobuf_->set_offset(end);
 
-  // If we've walked up to the end of the buffer, try shifting it to
-  // the beginning to make room; if there's no more room, fail --
-  // lines shouldn't be this long.
-  DCHECK(rv <= readiobuf_->RemainingCapacity());
-  if (readiobuf_->RemainingCapacity() == rv) {
-    if (read_start_ == 0) {
-      // Line is too long.
+  if (read_start_ == end) {
+    // Consumed everything; rewind to the start without moving anything.
+    readiobuf_->set_offset(0);
+    read_start_ = 0;
+  } else if (!readiobuf_->RemainingCapacity()) {
+    // We've walked up to the end of the buffer.  Shift the partial line
+    // to the beginning to make room, or grow the buffer if the line
+    // already fills it -- up to a limit, past which the peer is
+    // probably misbehaving.
+    if (read_start_ > 0) {
+      memmove(readiobuf_->StartOfBuffer(),
+              readiobuf_->StartOfBuffer() + read_start_, end - read_start_);
+      readiobuf_->set_offset(end - read_start_);
+      read_start_ = 0;
+    } else if (readiobuf_->capacity() >= kTorMaxLineSize) {
       VLOG(1) << "tor: control line too long";
       Error();
       return;
+    } else {
+      readiobuf_->SetCapacity(readiobuf_->capacity() * 2);
     }
-    memmove(readiobuf_->StartOfBuffer(),
-            readiobuf_->StartOfBuffer() + read_start_,
-            readiobuf_->offset() - read_start_ + rv);
-    readiobuf_->set_offset(readiobuf_->offset() - read_start_ + rv);
-    read_start_ = 0;
-  } else {
-    // Otherwise, just advance the offset by the size of this input.
-    readiobuf_->set_offset(readiobuf_->offset() + rv);
   }
   DCHECK(readiobuf_->RemainingCapacity());
 
@@ -763,7 +809,7 @@ void TorControl::ReadDone(int rv) {
     reading_ = false;
     readiobuf_.reset();
     read_start_ = 0;
-    read_cr_ = false;
+    data_reply_.reset();
     return;
   }
 }
@@ -773,9 +819,14 @@ void TorControl::ReadDone(int rv) {
 //      We have read a line of input; process it.  Return true on
 //      success, false on error.
 //
-bool TorControl::ReadLine(const std::string& line) {
+bool TorControl::ReadLine(base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
 
+  // Inside a data reply every line up to the terminating `.' belongs to
+  // the data block, whatever it looks like.
+  if (data_reply_)
+    return ReadDataLine(line);
+
   if (line.size() < 4) {
     // Line is too short.
     VLOG(1) << "tor: control line too short";
@@ -785,28 +836,28 @@ bool TorControl::ReadLine(const std::string& line) {
 
   // Parse out the line into status, position in reply stream, and
   // content: `xyzP...' where xyz are digits and P is `-' for an
-  // intermediate reply and ` ' for a final reply.
+  // intermediate reply, `+' for a data reply and ` ' for a final reply.
   //
   // TODO(riastradh): parse or check syntax of status
-  std::string status(line, 0, 3);
+  const std::string status(line.substr(0, 3));
   char pos = line[3];
-  std::string reply(line, 4);
+  const base::StringPiece reply = line.substr(4);
 
   // Determine whether it is an asynchronous reply, status 6yz.
   if (status[0] == '6') {
     // Notify delegate of the raw reply.
-    NotifyTorRawAsync(status, reply);
+    NotifyTorRawAsync(status, std::string(reply));
 
     // Is this a new async reply?
     if (!async_) {
       // Parse the keyword and the initial line.
       const size_t sp = reply.find(' ');
       std::string event_name, initial;
-      if (sp == std::string::npos) {
-        event_name = reply;
+      if (sp == base::StringPiece::npos) {
+        event_name = std::string(reply);
       } else {
-        event_name = reply.substr(0, sp);
-        initial = reply.substr(sp + 1);
+        event_name = std::string(reply.substr(0, sp));
+        initial = std::string(reply.substr(sp + 1));
       }
 
       // Discriminate on the position of the reply.
@@ -849,6 +900,23 @@ bool TorControl::ReadLine(const std::string& line) {
           async_->skip = (event == TorControlEvent::INVALID);
           return true;
         }
+        case '+': {
+          // Start of an async data reply, e.g. `650+NS'.  The data
+          // block follows, then a final `650 OK'.  Skip it if we don't
+          // recognize the event or aren't subscribed to it.
+          const auto& found = kTorControlEventByName.find(event_name);
+          const TorControlEvent event =
+              (found == kTorControlEventByName.end() ? TorControlEvent::INVALID
+                                                     : (*found).second);
+          async_ = std::make_unique<Async>();
+          async_->event = event;
+          async_->initial = initial;
+          async_->skip = (event == TorControlEvent::INVALID ||
+                          !async_events_.count(event));
+          data_reply_ = std::make_unique<DataReply>();
+          data_reply_->status = status;
+          return true;
+        }
       }
     } else {
       // We have an async reply ongoing.  Discriminate on the position
@@ -881,10 +949,27 @@ bool TorControl::ReadLine(const std::string& line) {
           async_->extra[key] = value;
           return true;
         }
+        case '+': {
+          // Another data block within an async reply.
+          data_reply_ = std::make_unique<DataReply>();
+          data_reply_->status = status;
+          return true;
+        }
         case ' ': {
           // End of an async reply.  Parse it and finish it, unless
           // we're skipping.
-          if (!async_->skip) {
+          if (!async_->skip && async_->data) {
+            // Data replies end with a bare `OK'.
+            if (reply != "OK") {
+              VLOG(1) << "tor: invalid async data reply end";
+              Error();
+              return false;
+            }
+            if (async_events_.count(async_->event)) {
+              NotifyTorEventData(async_->event, async_->initial,
+                                 *async_->data);
+            }
+          } else if (!async_->skip) {
             std::string key, value;
             if (!ParseKV(reply, &key, &value)) {
               VLOG(1) << "tor: invalid async event";
@@ -913,26 +998,33 @@ bool TorControl::ReadLine(const std::string& line) {
     // Synchronous reply.  Return it to the next command callback in
     // the queue.
     switch (pos) {
-      case '-':
-        NotifyTorRawMid(status, reply);
+      case '-': {
+        const std::string reply_str(reply);
+        NotifyTorRawMid(status, reply_str);
         if (!cmdq_.empty()) {
           PerLineCallback& perline = cmdq_.front().first;
-          perline.Run(status, reply);
+          perline.Run(status, reply_str);
         }
         return true;
+      }
       case '+':
-        VLOG(2) << "tor: NYI: control data reply";
-        // XXX Just ignore it for now.
+        // Start of a data reply, e.g. `250+ns/all='.  Collect the data
+        // block and hand it to the per-line callback as one reply.
+        data_reply_ = std::make_unique<DataReply>();
+        data_reply_->status = status;
+        data_reply_->reply = std::string(reply);
         return true;
-      case ' ':
-        NotifyTorRawEnd(status, reply);
+      case ' ': {
+        const std::string reply_str(reply);
+        NotifyTorRawEnd(status, reply_str);
         if (!cmdq_.empty()) {
           CmdCallback& callback = cmdq_.front().second;
           bool error = false;
-          std::move(callback).Run(error, status, reply);
+          std::move(callback).Run(error, status, reply_str);
           cmdq_.pop();
         }
         return true;
+      }
     }
   }
 
@@ -943,9 +1035,57 @@ bool TorControl::ReadLine(const std::string& line) {
   return false;
 }
 
+// ReadDataLine(line)
+//
+//      We have read a line of a data reply; accumulate it, or finish
+//      the data reply if it is the terminating `.'.  Return true on
+//      success, false on error.
+//
+bool TorControl::ReadDataLine(base::StringPiece line) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  DCHECK(data_reply_);
+
+  if (line != ".") {
+    // Skipped async replies are parsed but not kept.
+    if (async_ && async_->skip)
+      return true;
+    // Lines starting with `.' are escaped by doubling it.
+    if (!line.empty() && line[0] == '.')
+      line.remove_prefix(1);
+    if (!data_reply_->data.empty())
+      data_reply_->data.push_back('\n');
+    data_reply_->data.append(line.data(), line.size());
+    return true;
+  }
+
+  std::unique_ptr<DataReply> data_reply = std::move(data_reply_);
+  if (async_) {
+    // The async reply is finished by its final `650 OK' line.
+    if (!async_->skip) {
+      if (!async_->data) {
+        async_->data = std::make_unique<std::string>(std::move(data_reply->data));
+      } else {
+        async_->data->push_back('\n');
+        async_->data->append(data_reply->data);
+      }
+    }
+    return true;
+  }
+
+  NotifyTorRawMid(data_reply->status, data_reply->reply);
+  if (!cmdq_.empty()) {
+    PerLineCallback& perline = cmdq_.front().first;
+    perline.Run(data_reply->status, data_reply->reply + data_reply->data);
+  }
+  return true;
+}
+
 TorControl::Async::Async() = default;
 TorControl::Async::~Async() = default;
 
+TorControl::DataReply::DataReply() = default;
+TorControl::DataReply::~DataReply() = default;
+
 // Error()
 //
 //      Clear read and write state and disconnect.
@@ -967,7 +1107,8 @@ void TorControl::Error() {
   reading_ = false;
   readiobuf_.reset();
   read_start_ = -1;
-  read_cr_ = false;
+  data_reply_.reset();
+  async_.reset();
 
   // Clear write state.
   writeq_ = {};
@@ -1001,6 +1142,15 @@ void TorControl::NotifyTorEvent(
       base::BindOnce(&Delegate::OnTorEvent, delegate_, event, initial, extra));
 }
 
+void TorControl::NotifyTorEventData(TorControlEvent event,
+                                    const std::string& initial,
+                                    const std::string& data) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  owner_task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(&Delegate::OnTorEventData, delegate_, event,
+                                initial, data));
+}
+
 void TorControl::NotifyTorRawCmd(const std::string& cmd) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
@@ -1038,7 +1188,7 @@ void TorControl::NotifyTorRawEnd(const std::string& status,
 //      success, false on failure.
 //
 // static
-bool TorControl::ParseKV(const std::string& string,
+bool TorControl::ParseKV(base::StringPiece string,
                          std::string* key,
                          std::string* value) {
   size_t end;
@@ -1053,20 +1203,20 @@ bool TorControl::ParseKV(const std::string& string,
 //      failure.
 //
 // static
-bool TorControl::ParseKV(const std::string& string,
+bool TorControl::ParseKV(base::StringPiece string,
                          std::string* key,
                          std::string* value,
                          size_t* end) {
   DCHECK(key && value && end);
   // Search for `=' -- it had better be there.
-  size_t eq = string.find("=");
-  if (eq == std::string::npos)
+  size_t eq = string.find('=');
+  if (eq == base::StringPiece::npos)
     return false;
   size_t vstart = eq + 1;
 
   // If we're at the end of the string, value is empt.
   if (vstart == string.size()) {
-    *key = string.substr(0, eq);
+    *key = std::string(string.substr(0, eq));
     *value = "";
     *end = string.size();
     return true;
@@ -1076,7 +1226,7 @@ bool TorControl::ParseKV(const std::string& string,
   if (string[vstart] != '"') {
     // Not quoted.  Check for a delimiter.
     size_t i, vend = string.size();
-    if ((i = string.find(" ", vstart)) != std::string::npos) {
+    if ((i = string.find(' ', vstart)) != base::StringPiece::npos) {
       // Delimited.  Stop at the delimiter, and consume it.
       vend = i;
       *end = vend + 1;
@@ -1086,19 +1236,19 @@ bool TorControl::ParseKV(const std::string& string,
     }
 
     // Check for internal quotes; they are forbidden.
-    if ((i = string.find("\"", vstart)) != std::string::npos)
+    if ((i = string.find('"', vstart)) != base::StringPiece::npos)
       return false;
 
     // Extract the key and value and we're done.
-    *key = string.substr(0, eq);
-    *value = string.substr(vstart, vend - vstart);
+    *key = std::string(string.substr(0, eq));
+    *value = std::string(string.substr(vstart, vend - vstart));
     return true;
   }
 
   // Quoted string.  Parse it, and consume trailing spaces.
   if (!ParseQuoted(string.substr(eq + 1), value, end))
     return false;
-  *key = string.substr(0, eq);
+  *key = std::string(string.substr(0, eq));
   *end += eq + 1;
   while (*end < string.size() && string[*end] == ' ')
     (*end)++;
@@ -1113,7 +1263,7 @@ bool TorControl::ParseKV(const std::string& string,
 //      return false on failure.
 //
 // static
-bool TorControl::ParseQuoted(const std::string& string,
+bool TorControl::ParseQuoted(base::StringPiece string,
                              std::string* value,
                              size_t* end) {
   enum {
@@ -18,6 +18,7 @@
 #include "base/callback.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 
 namespace base {
 class SequencedTaskRunner;
@@ -61,6 +62,13 @@ class TorControl {
         const std::string& initial,
         const std::map<std::string, std::string>& extra) = 0;
 
+    // Events which use data replies (NS, NEWCONSENSUS, HS_DESC_CONTENT) are
+    // delivered here instead of OnTorEvent. |data| is the unescaped data
+    // block with lines joined by LF.
+    virtual void OnTorEventData(TorControlEvent,
+                                const std::string& initial,
+                                const std::string& data) {}
+
     // Debugging options.
     virtual void OnTorRawCmd(const std::string& cmd) {}
     virtual void OnTorRawAsync(const std::string& status,
@@ -92,22 +100,30 @@ class TorControl {
           callback);
   void GetCircuitEstablished(
       base::OnceCallback<void(bool error, bool established)> callback);
+  // Ask Tor to build a new general purpose circuit along a path of its
+  // choosing.  Callback receives the circuit id once the build is underway;
+  // completion is reported through CIRC events.
+  void ExtendCircuit(
+      base::OnceCallback<void(bool error, const std::string& circuit_id)>
+          callback);
 
  protected:
   friend class TorControlTest;
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ParseQuoted);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ParseKV);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ReadLine);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, ReadDataReply);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, GetCircuitEstablishedDone);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, ExtendCircuitDone);
 
-  static bool ParseKV(const std::string& string,
+  static bool ParseKV(base::StringPiece string,
                       std::string* key,
                       std::string* value);
-  static bool ParseKV(const std::string& string,
+  static bool ParseKV(base::StringPiece string,
                       std::string* key,
                       std::string* value,
                       size_t* end);
-  static bool ParseQuoted(const std::string& string,
+  static bool ParseQuoted(base::StringPiece string,
                           std::string* value,
                           size_t* end);
 
@@ -149,6 +165,12 @@ class TorControl {
       bool error,
       const std::string& status,
       const std::string& reply);
+  void ExtendCircuitDone(
+      base::OnceCallback<void(bool error, const std::string& circuit_id)>
+          callback,
+      bool error,
+      const std::string& status,
+      const std::string& reply);
 
   void DoSubscribe(TorControlEvent event,
                    base::OnceCallback<void(bool error)> callback);
@@ -173,6 +195,9 @@ class TorControl {
   void NotifyTorEvent(TorControlEvent,
                       const std::string& initial,
                       const std::map<std::string, std::string>& extra);
+  void NotifyTorEventData(TorControlEvent,
+                          const std::string& initial,
+                          const std::string& data);
   void NotifyTorRawCmd(const std::string& cmd);
   void NotifyTorRawAsync(const std::string& status, const std::string& line);
   void NotifyTorRawMid(const std::string& status, const std::string& line);
@@ -187,7 +212,8 @@ class TorControl {
   void DoReads();
   void ReadDoneAsync(int rv);
   void ReadDone(int rv);
-  bool ReadLine(const std::string& line);
+  bool ReadLine(base::StringPiece line);
+  bool ReadDataLine(base::StringPiece line);
 
   void Error();
 
@@ -213,7 +239,17 @@ class TorControl {
   bool reading_;
   scoped_refptr<net::GrowableIOBuffer> readiobuf_;
   int read_start_;  // offset where the current line starts
-  bool read_cr_;    // true if we have parsed a CR
+
+  // Data reply (`xyz+keyword=' followed by lines up to a lone `.') state
+  // machine.  Present only while we are inside the data block.
+  struct DataReply {
+    DataReply();
+    ~DataReply();
+    std::string status;
+    std::string reply;  // the text following `xyz+'
+    std::string data;
+  };
+  std::unique_ptr<DataReply> data_reply_;
 
   // Asynchronous command response callback state machine.
   std::map<TorControlEvent, size_t> async_events_;
@@ -223,6 +259,7 @@ class TorControl {
     TorControlEvent event;
     std::string initial;
     std::map<std::string, std::string> extra;
+    std::unique_ptr<std::string> data;  // set if the reply had a data block
     bool skip;
   };
   std::unique_ptr<Async> async_;
@@ -22,13 +22,13 @@ TOR_EVENT(DESCCHANGED)
 TOR_EVENT(ERR)
 TOR_EVENT(GUARD)
 TOR_EVENT(HS_DESC)
-// TOR_EVENT(HS_DESC_CONTENT)   // omitted because uses data replies
+TOR_EVENT(HS_DESC_CONTENT)
 TOR_EVENT(INFO)
 TOR_EVENT(NETWORK_LIVENESS)
-// TOR_EVENT(NEWCONSENSUS)      // omitted because uses data replies
+TOR_EVENT(NEWCONSENSUS)
 TOR_EVENT(NEWDESC)
 TOR_EVENT(NOTICE)
-// TOR_EVENT(NS)                // omitted because uses data replies
+TOR_EVENT(NS)
 TOR_EVENT(ORCONN)
 TOR_EVENT(SIGNAL)
 TOR_EVENT(STATUS_CLIENT)
@@ -5,8 +5,16 @@
 
 #include "brave/components/tor/tor_control.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "base/callback_helpers.h"
 #include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "brave/components/tor/fake_tor_control_server.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/test/browser_task_environment.h"
@@ -27,6 +35,61 @@ class MockTorControlDelegate : public TorControl::Delegate {
   MOCK_METHOD2(OnTorRawAsync, void(const std::string&, const std::string&));
   MOCK_METHOD2(OnTorRawMid, void(const std::string&, const std::string&));
   MOCK_METHOD2(OnTorRawEnd, void(const std::string&, const std::string&));
+  MOCK_METHOD3(OnTorEventData,
+               void(TorControlEvent, const std::string&, const std::string&));
+};
+
+class CountingTorControlDelegate : public TorControl::Delegate {
+ public:
+  CountingTorControlDelegate(size_t expected_events,
+                             size_t expected_data_events,
+                             base::OnceClosure done)
+      : expected_events_(expected_events),
+        expected_data_events_(expected_data_events),
+        done_(std::move(done)) {}
+
+  void set_control(TorControl* control) { control_ = control; }
+
+  size_t events() const { return events_; }
+  size_t data_events() const { return data_events_; }
+  size_t data_bytes() const { return data_bytes_; }
+
+  void OnTorControlReady() override {
+    control_->Subscribe(TorControlEvent::CIRC_BW,
+                        base::DoNothing::Once<bool>());
+    control_->Subscribe(TorControlEvent::NS, base::DoNothing::Once<bool>());
+  }
+  void OnTorControlClosed(bool was_running) override {}
+  void OnTorEvent(TorControlEvent event,
+                  const std::string& initial,
+                  const std::map<std::string, std::string>& extra) override {
+    EXPECT_EQ(event, TorControlEvent::CIRC_BW);
+    events_++;
+    MaybeDone();
+  }
+  void OnTorEventData(TorControlEvent event,
+                      const std::string& initial,
+                      const std::string& data) override {
+    EXPECT_EQ(event, TorControlEvent::NS);
+    data_events_++;
+    data_bytes_ += data.size();
+    MaybeDone();
+  }
+
+ private:
+  void MaybeDone() {
+    if (done_ && events_ == expected_events_ &&
+        data_events_ == expected_data_events_)
+      std::move(done_).Run();
+  }
+
+  TorControl* control_ = nullptr;
+  size_t expected_events_;
+  size_t expected_data_events_;
+  size_t events_ = 0;
+  size_t data_events_ = 0;
+  size_t data_bytes_ = 0;
+  base::OnceClosure done_;
 };
 }  // namespace
 
@@ -184,6 +247,143 @@ TEST(TorControlTest, ReadLine) {
   base::RunLoop().RunUntilIdle();
 }
 
+TEST(TorControlTest, ReadDataReply) {
+  content::BrowserTaskEnvironment task_environment;
+  scoped_refptr<base::SequencedTaskRunner> io_task_runner =
+      content::GetIOThreadTaskRunner({});
+
+  MockTorControlDelegate delegate;
+  std::unique_ptr<TorControl> control =
+      std::make_unique<TorControl>(delegate.AsWeakPtr(), io_task_runner);
+
+  using tor::TorControlEvent;
+  EXPECT_CALL(delegate, OnTorRawAsync("650", testing::_)).Times(4);
+  EXPECT_CALL(delegate,
+              OnTorEventData(TorControlEvent::NS, "",
+                             "r relay1 AAAA\ns Fast Running\n.dotted"))
+      .Times(1);
+  EXPECT_CALL(delegate,
+              OnTorEventData(TorControlEvent::NEWCONSENSUS, testing::_,
+                             testing::_))
+      .Times(0);
+  io_task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](std::unique_ptr<TorControl> control) {
+            control->async_events_[TorControlEvent::NS] = 1;
+            EXPECT_TRUE(control->ReadLine("650+NS"));
+            EXPECT_TRUE(control->data_reply_);
+            EXPECT_TRUE(control->ReadLine("r relay1 AAAA"));
+            EXPECT_TRUE(control->ReadLine("s Fast Running"));
+            EXPECT_TRUE(control->ReadLine("..dotted"));
+            EXPECT_TRUE(control->ReadLine("."));
+            EXPECT_FALSE(control->data_reply_);
+            EXPECT_TRUE(control->async_);
+            EXPECT_TRUE(control->ReadLine("650 OK"));
+            EXPECT_FALSE(control->async_);
+            // Not subscribed: data is parsed and dropped.
+            EXPECT_TRUE(control->ReadLine("650+NEWCONSENSUS"));
+            EXPECT_TRUE(control->ReadLine("r relay2 BBBB"));
+            EXPECT_TRUE(control->ReadLine("."));
+            EXPECT_TRUE(control->ReadLine("650 OK"));
+            EXPECT_FALSE(control->async_);
+          },
+          std::move(control)));
+
+  // Synchronous data reply is handed to the per-line callback as a whole.
+  control.reset(new TorControl(delegate.AsWeakPtr(), io_task_runner));
+  EXPECT_CALL(delegate, OnTorRawMid("250", "config-text=")).Times(1);
+  EXPECT_CALL(delegate, OnTorRawEnd("250", "OK")).Times(1);
+  io_task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](std::unique_ptr<TorControl> control) {
+            std::string reply;
+            bool done = false;
+            control->cmdq_.push(std::make_pair(
+                base::BindRepeating(
+                    [](std::string* out, const std::string& status,
+                       const std::string& reply) { *out = reply; },
+                    &reply),
+                base::BindOnce([](bool* done, bool error,
+                                  const std::string& status,
+                                  const std::string& reply) { *done = true; },
+                               &done)));
+            EXPECT_TRUE(control->ReadLine("250+config-text="));
+            EXPECT_TRUE(control->ReadLine("SocksPort 9050"));
+            EXPECT_TRUE(control->ReadLine("ControlPort 9051"));
+            EXPECT_TRUE(control->ReadLine("."));
+            EXPECT_EQ(reply, "config-text=SocksPort 9050\nControlPort 9051");
+            EXPECT_FALSE(done);
+            EXPECT_TRUE(control->ReadLine("250 OK"));
+            EXPECT_TRUE(done);
+          },
+          std::move(control)));
+
+  base::RunLoop().RunUntilIdle();
+}
+
+// Replays a large control-port transcript of high-volume events through a
+// real socket and checks that every event is delivered.
+TEST(TorControlTest, FakeControlPortTranscript) {
+  base::test::TaskEnvironment task_environment(
+      base::test::TaskEnvironment::MainThreadType::IO);
+
+  const size_t kEvents = 100000;
+  const size_t kDataEvents = 100;
+  const size_t kDataLines = 200;
+  std::string transcript;
+  for (size_t i = 0; i < kEvents; i++) {
+    transcript += base::StringPrintf(
+        "650 CIRC_BW ID=%zu READ=%zu WRITTEN=%zu "
+        "TIME=2020-11-05T12:00:00.000000\r\n",
+        i % 64, i * 509, i * 498);
+    if (i % (kEvents / kDataEvents) == 0) {
+      transcript += "650+NS\r\n";
+      for (size_t j = 0; j < kDataLines; j++) {
+        transcript += base::StringPrintf(
+            "r relay%zu qCIhvmjfGgaJ5W9tWd6E6qEvkDg 2020-11-05 10:25:03 "
+            "192.0.2.%zu 9001 0\r\ns Fast Guard Running Stable Valid\r\n",
+            j, j % 256);
+      }
+      transcript += ".\r\n650 OK\r\n";
+    }
+  }
+
+  // Replay the transcript once both events have been subscribed.
+  FakeTorControlServer server;
+  server.set_command_handler(base::BindRepeating(
+      [](const std::string* transcript, bool* replayed,
+         const std::string& cmd) -> std::string {
+        std::string out = "250 OK\r\n";
+        if (!*replayed && cmd.find(" CIRC_BW") != std::string::npos &&
+            cmd.find(" NS") != std::string::npos) {
+          *replayed = true;
+          out += *transcript;
+        }
+        return out;
+      },
+      &transcript, base::Owned(std::make_unique<bool>(false))));
+  const int port = server.Listen();
+
+  base::RunLoop run_loop;
+  CountingTorControlDelegate delegate(kEvents, kDataEvents,
+                                      run_loop.QuitClosure());
+  std::unique_ptr<TorControl> control = std::make_unique<TorControl>(
+      delegate.AsWeakPtr(), base::SequencedTaskRunnerHandle::Get());
+  delegate.set_control(control.get());
+
+  control->Start(std::vector<uint8_t>(32, 0), port);
+  run_loop.Run();
+
+  EXPECT_EQ(delegate.events(), kEvents);
+  EXPECT_EQ(delegate.data_events(), kDataEvents);
+  EXPECT_GT(delegate.data_bytes(), 0u);
+
+  control->Stop();
+  base::RunLoop().RunUntilIdle();
+}
+
 TEST(TorControlTest, GetCircuitEstablishedDone) {
   content::BrowserTaskEnvironment task_environment;
   scoped_refptr<base::SequencedTaskRunner> io_task_runner =
@@ -300,4 +500,50 @@ TEST(TorControlTest, GetCircuitEstablishedDone) {
   base::RunLoop().RunUntilIdle();
 }
 
+TEST(TorControlTest, ExtendCircuitDone) {
+  content::BrowserTaskEnvironment task_environment;
+  scoped_refptr<base::SequencedTaskRunner> io_task_runner =
+      content::GetIOThreadTaskRunner({});
+
+  MockTorControlDelegate delegate;
+  std::unique_ptr<TorControl> control =
+      std::make_unique<TorControl>(delegate.AsWeakPtr(), io_task_runner);
+
+  io_task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](std::unique_ptr<TorControl> control) {
+            const struct {
+              bool error;
+              const char* status;
+              const char* reply;
+              bool expected_error;
+              const char* expected_id;
+            } cases[] = {
+                {false, "250", "EXTENDED 42", false, "42"},
+                {false, "250", "EXTENDED ", true, ""},
+                {false, "250", "OK", true, ""},
+                {false, "552", "Unknown circuit", true, ""},
+                {true, "250", "EXTENDED 42", true, ""},
+            };
+            for (const auto& c : cases) {
+              bool is_called = false;
+              control->ExtendCircuitDone(
+                  base::BindOnce(
+                      [](bool* is_called, bool expected_error,
+                         const char* expected_id, bool error,
+                         const std::string& circuit_id) {
+                        *is_called = true;
+                        EXPECT_EQ(error, expected_error);
+                        EXPECT_EQ(circuit_id, expected_id);
+                      },
+                      &is_called, c.expected_error, c.expected_id),
+                  c.error, c.status, c.reply);
+              EXPECT_TRUE(is_called) << c.reply;
+            }
+          },
+          std::move(control)));
+  base::RunLoop().RunUntilIdle();
+}
+
 }  // namespace tor
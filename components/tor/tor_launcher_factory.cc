@@ -39,6 +39,9 @@ TorLauncherFactory::TorLauncherFactory()
       control_(new tor::TorControl(this->AsWeakPtr(),
                                    content::GetIOThreadTaskRunner({})),
                base::OnTaskRunnerDeleter(content::GetIOThreadTaskRunner({}))),
+      circuit_pool_(std::make_unique<tor::TorCircuitPool>(
+          control_.get(),
+          tor::TorCircuitPool::kDefaultSize)),
       weak_ptr_factory_(this) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 }
@@ -110,6 +113,7 @@ void TorLauncherFactory::KillTorProcess() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   if (tor_launcher_.is_bound())
     tor_launcher_->Shutdown();
+  circuit_pool_->Stop();
   control_->Stop();
   tor_launcher_.reset();
   tor_pid_ = -1;
@@ -118,6 +122,11 @@ void TorLauncherFactory::KillTorProcess() {
   tor_log_.clear();
 }
 
+void TorLauncherFactory::PrewarmCircuit(const std::string& isolation_key) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  circuit_pool_->Prewarm(isolation_key);
+}
+
 int64_t TorLauncherFactory::GetTorPid() const {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   return tor_pid_;
@@ -266,6 +275,8 @@ void TorLauncherFactory::GotCircuitEstablished(bool error, bool established) {
     return;
   }
   is_connected_ = established;
+  if (established)
+    circuit_pool_->Start();
   for (auto& observer : observers_)
     observer.OnTorCircuitEstablished(established);
 }
@@ -273,6 +284,7 @@ void TorLauncherFactory::GotCircuitEstablished(bool error, bool established) {
 void TorLauncherFactory::OnTorControlClosed(bool was_running) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   VLOG(2) << "TOR CONTROL: Closed!";
+  circuit_pool_->Stop();
   // We only try to reestablish tor control connection when tor control was
   // closed unexpectedly and Tor process is still running
   if (was_running && tor_launcher_.is_bound()) {
@@ -351,11 +363,16 @@ void TorLauncherFactory::OnTorEvent(
       for (auto& observer : observers_)
         observer.OnTorCircuitEstablished(true);
       is_connected_ = true;
+      circuit_pool_->Start();
     } else if (initial.find(kStatusClientCircuitNotEstablished) !=
                std::string::npos) {
       for (auto& observer : observers_)
         observer.OnTorCircuitEstablished(false);
     }
+  } else if (event == tor::TorControlEvent::CIRC) {
+    circuit_pool_->OnCircuitEvent(initial);
+  } else if (event == tor::TorControlEvent::STREAM) {
+    circuit_pool_->OnStreamEvent(initial);
   } else if (event == tor::TorControlEvent::NOTICE ||
              event == tor::TorControlEvent::WARN ||
              event == tor::TorControlEvent::ERR) {
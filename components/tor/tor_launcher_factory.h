@@ -18,6 +18,7 @@
 #include "base/observer_list.h"
 #include "base/sequence_checker.h"
 #include "brave/components/services/tor/public/interfaces/tor.mojom.h"
+#include "brave/components/tor/tor_circuit_pool.h"
 #include "brave/components/tor/tor_control.h"
 #include "mojo/public/cpp/bindings/remote.h"
 
@@ -42,6 +43,9 @@ class TorLauncherFactory : public tor::TorControl::Delegate {
   virtual std::string GetTorProxyURI() const;
   virtual std::string GetTorVersion() const;
   virtual void GetTorLog(GetLogCallback);
+  // Hint that a site with |isolation_key| is about to be loaded so a clean
+  // circuit can be built ahead of time.
+  virtual void PrewarmCircuit(const std::string& isolation_key);
 
   void AddObserver(TorLauncherObserver* observer);
   void RemoveObserver(TorLauncherObserver* observer);
@@ -99,6 +103,7 @@ class TorLauncherFactory : public tor::TorControl::Delegate {
   base::ObserverList<TorLauncherObserver> observers_;
 
   std::unique_ptr<tor::TorControl, base::OnTaskRunnerDeleter> control_;
+  std::unique_ptr<tor::TorCircuitPool> circuit_pool_;
 
   SEQUENCE_CHECKER(sequence_checker_);
 
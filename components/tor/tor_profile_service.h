@@ -20,6 +20,8 @@ namespace content {
 class WebContents;
 }
 
+class GURL;
+
 namespace net {
 class ProxyConfigService;
 }
@@ -44,6 +46,8 @@ class TorProfileService : public KeyedService {
   virtual void RegisterTorClientUpdater() = 0;
   virtual void UnregisterTorClientUpdater() = 0;
   virtual void SetNewTorCircuit(content::WebContents* web_contents) = 0;
+  // Navigation to |url| is likely; get a circuit ready for its site.
+  virtual void PrewarmCircuit(const GURL& url) = 0;
   virtual std::unique_ptr<net::ProxyConfigService>
       CreateProxyConfigService() = 0;
   virtual bool IsTorConnected() = 0;
@@ -41,6 +41,9 @@ namespace tor {
 
 namespace {
 
+constexpr base::TimeDelta kPrewarmCircuitDelay =
+    base::TimeDelta::FromMilliseconds(300);
+
 class NewTorCircuitTracker : public WebContentsObserver {
  public:
   explicit NewTorCircuitTracker(content::WebContents* web_contents)
@@ -205,6 +208,26 @@ void TorProfileServiceImpl::SetNewTorCircuit(WebContents* tab) {
       url, network_isolation_key, std::move(proxy_lookup_client));
 }
 
+void TorProfileServiceImpl::PrewarmCircuit(const GURL& url) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!tor_launcher_factory_ || !url.SchemeIsHTTPOrHTTPS())
+    return;
+  // Called on every omnibox keystroke; only prewarm for the destination the
+  // user settles on.
+  prewarm_timer_.Start(
+      FROM_HERE, kPrewarmCircuitDelay,
+      base::BindOnce(&TorProfileServiceImpl::DoPrewarmCircuit,
+                     base::Unretained(this),
+                     net::ProxyConfigServiceTor::CircuitIsolationKey(url)));
+}
+
+void TorProfileServiceImpl::DoPrewarmCircuit(
+    const std::string& isolation_key) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (tor_launcher_factory_)
+    tor_launcher_factory_->PrewarmCircuit(isolation_key);
+}
+
 void TorProfileServiceImpl::KillTor() {
   if (tor_launcher_factory_)
     tor_launcher_factory_->KillTorProcess();
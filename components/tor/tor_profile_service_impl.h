@@ -10,6 +10,7 @@
 #include <string>
 
 #include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 #include "brave/components/tor/brave_tor_client_updater.h"
 #include "brave/components/tor/tor_launcher_factory.h"
 #include "brave/components/tor/tor_launcher_observer.h"
@@ -43,6 +44,7 @@ class TorProfileServiceImpl : public TorProfileService,
   void RegisterTorClientUpdater() override;
   void UnregisterTorClientUpdater() override;
   void SetNewTorCircuit(content::WebContents* web_contents) override;
+  void PrewarmCircuit(const GURL& url) override;
   std::unique_ptr<net::ProxyConfigService> CreateProxyConfigService() override;
   bool IsTorConnected() override;
   void KillTor() override;
@@ -53,6 +55,7 @@ class TorProfileServiceImpl : public TorProfileService,
 
  private:
   void LaunchTor();
+  void DoPrewarmCircuit(const std::string& isolation_key);
 
   base::FilePath GetTorExecutablePath() const;
   base::FilePath GetTorDataPath() const;
@@ -65,6 +68,7 @@ class TorProfileServiceImpl : public TorProfileService,
   BraveTorClientUpdater* tor_client_updater_ = nullptr;
   TorLauncherFactory* tor_launcher_factory_;  // Singleton
   net::ProxyConfigServiceTor* proxy_config_service_;  // NOT OWNED
+  base::OneShotTimer prewarm_timer_;
   base::WeakPtrFactory<TorProfileServiceImpl> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(TorProfileServiceImpl);
@@ -5,8 +5,10 @@
 
 #include "brave/components/tor/tor_tab_helper.h"
 
+#include "base/metrics/histogram_macros.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "content/public/browser/navigation_handle.h"
+#include "content/public/browser/navigation_handle_timing.h"
 
 namespace tor {
 
@@ -25,6 +27,8 @@ void TorTabHelper::MaybeCreateForWebContents(content::WebContents* web_contents,
 
 void TorTabHelper::DidFinishNavigation(
     content::NavigationHandle* navigation_handle) {
+  RecordTimeToFirstByte(navigation_handle);
+
   // We will keep retrying every second if we can't establish connection to tor
   // process. This is possible when tor is launched but not yet ready to accept
   // new connection or some fatal errors within tor process
@@ -37,6 +41,23 @@ void TorTabHelper::DidFinishNavigation(
       base::TimeDelta::FromSeconds(1));
 }
 
+void TorTabHelper::RecordTimeToFirstByte(
+    content::NavigationHandle* navigation_handle) {
+  if (!navigation_handle->IsInMainFrame() ||
+      navigation_handle->IsSameDocument() ||
+      !navigation_handle->HasCommitted() || navigation_handle->IsErrorPage())
+    return;
+  const base::TimeTicks first_response_start =
+      navigation_handle->GetNavigationHandleTiming().first_response_start_time;
+  if (first_response_start.is_null())
+    return;
+  // Includes circuit construction when the site had no circuit yet, which is
+  // what the circuit pool is meant to hide.
+  UMA_HISTOGRAM_MEDIUM_TIMES(
+      "Brave.Tor.MainFrameTimeToFirstByte",
+      first_response_start - navigation_handle->NavigationStart());
+}
+
 void TorTabHelper::ReloadTab(content::WebContents* web_contents) {
   DCHECK(web_contents);
   web_contents->GetController().Reload(content::ReloadType::NORMAL, false);
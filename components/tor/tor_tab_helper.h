@@ -34,6 +34,7 @@ class TorTabHelper : public content::WebContentsObserver,
   void DidFinishNavigation(
       content::NavigationHandle* navigation_handle) override;
 
+  void RecordTimeToFirstByte(content::NavigationHandle* navigation_handle);
   void ReloadTab(content::WebContents* web_contents);
 
   WEB_CONTENTS_USER_DATA_KEY_DECL();